@@ -0,0 +1,240 @@
+/**
+ * @file ddrconf.c
+ * @brief Shared helpers for runtime-loaded DDR configurations
+ *
+ * Every reader produces a struct ddrconf whose arrays live in a single
+ * heap block or file mapping, so that releasing a configuration is one
+ * call no matter where it was loaded from.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "ddrconf.h"
+#include "ddrsnap.h"
+
+/* Alignment of every array inside a packed block */
+#define PACK_ALIGN 8U
+
+struct pack_ctx {
+	unsigned char *base;  /* NULL while sizing */
+	size_t off;
+};
+
+/**
+ * @brief Reserve (and, once base is set, fill) room for one array
+ *
+ * @return Address of the copy, or NULL while sizing or for empty arrays
+ */
+static void *pack_array(struct pack_ctx *ctx, const void *src, size_t size) {
+	void *dst = NULL;
+
+	if (!src || size == 0) {
+		return NULL;
+	}
+
+	ctx->off = (ctx->off + PACK_ALIGN - 1) & ~(size_t)(PACK_ALIGN - 1);
+	if (ctx->base) {
+		dst = ctx->base + ctx->off;
+		memcpy(dst, src, size);
+	}
+	ctx->off += size;
+
+	return dst;
+}
+
+/**
+ * @brief Walk a timing description, copying every array it references
+ *
+ * Called once with ctx->base == NULL to compute the block size and once
+ * more to perform the copy.
+ */
+static void pack_timing(struct pack_ctx *ctx, const struct dram_timing_info *src,
+                        struct dram_timing_info *dst) {
+	struct dram_fsp_cfg *fsp_cfg;
+	struct dram_fsp_msg *fsp_msg;
+	void *p;
+
+	*dst = *src;
+
+	dst->ddrc_cfg = pack_array(ctx, src->ddrc_cfg,
+	                           src->ddrc_cfg_num * sizeof(struct ddrc_cfg_param));
+
+	fsp_cfg = pack_array(ctx, src->fsp_cfg, src->fsp_cfg_num * sizeof(struct dram_fsp_cfg));
+	dst->fsp_cfg = fsp_cfg;
+	for (unsigned int i = 0; src->fsp_cfg && i < src->fsp_cfg_num; i++) {
+		const struct dram_fsp_cfg *s = &src->fsp_cfg[i];
+
+		p = pack_array(ctx, s->ddrc_cfg, s->ddrc_cfg_num * sizeof(struct ddrc_cfg_param));
+		if (fsp_cfg) fsp_cfg[i].ddrc_cfg = p;
+		p = pack_array(ctx, s->mr_cfg, s->mr_cfg_num * sizeof(struct ddrc_cfg_param));
+		if (fsp_cfg) fsp_cfg[i].mr_cfg = p;
+	}
+
+	dst->ddrphy_cfg = pack_array(ctx, src->ddrphy_cfg,
+	                             src->ddrphy_cfg_num * sizeof(struct ddrphy_cfg_param));
+
+	fsp_msg = pack_array(ctx, src->fsp_msg, src->fsp_msg_num * sizeof(struct dram_fsp_msg));
+	dst->fsp_msg = fsp_msg;
+	for (unsigned int i = 0; src->fsp_msg && i < src->fsp_msg_num; i++) {
+		const struct dram_fsp_msg *s = &src->fsp_msg[i];
+
+		p = pack_array(ctx, s->fsp_phy_cfg,
+		               s->fsp_phy_cfg_num * sizeof(struct ddrphy_cfg_param));
+		if (fsp_msg) fsp_msg[i].fsp_phy_cfg = p;
+		p = pack_array(ctx, s->fsp_phy_msgh_cfg,
+		               s->fsp_phy_msgh_cfg_num * sizeof(struct ddrphy_cfg_param));
+		if (fsp_msg) fsp_msg[i].fsp_phy_msgh_cfg = p;
+		p = pack_array(ctx, s->fsp_phy_pie_cfg,
+		               s->fsp_phy_pie_cfg_num * sizeof(struct ddrphy_cfg_param));
+		if (fsp_msg) fsp_msg[i].fsp_phy_pie_cfg = p;
+		p = pack_array(ctx, s->fsp_phy_prog_csr_ps_cfg,
+		               s->fsp_phy_prog_csr_ps_cfg_num * sizeof(struct ddrphy_cfg_param));
+		if (fsp_msg) fsp_msg[i].fsp_phy_prog_csr_ps_cfg = p;
+	}
+
+	dst->ddrphy_trained_csr = pack_array(ctx, src->ddrphy_trained_csr,
+	                                     src->ddrphy_trained_csr_num * sizeof(struct ddrphy_cfg_param));
+	dst->ddrphy_pie = pack_array(ctx, src->ddrphy_pie,
+	                             src->ddrphy_pie_num * sizeof(struct ddrphy_cfg_param));
+	dst->ddrphy_prog_csr = pack_array(ctx, src->ddrphy_prog_csr,
+	                                  src->ddrphy_prog_csr_num * sizeof(struct ddrphy_cfg_param));
+}
+
+/**
+ * @brief Deep-copy a timing description into a single heap block
+ *
+ * @param src Timing description whose arrays may live anywhere
+ * @param conf Output configuration (previous contents are overwritten)
+ * @return 0 on success, -1 on allocation failure
+ */
+int ddrconf_pack(const struct dram_timing_info *src, struct ddrconf *conf) {
+	struct pack_ctx ctx = { NULL, 0 };
+	struct dram_timing_info scratch;
+
+	pack_timing(&ctx, src, &scratch);
+
+	memset(conf, 0, sizeof(*conf));
+	conf->mem_size = ctx.off;
+	conf->mem = malloc(ctx.off ? ctx.off : 1);
+	if (!conf->mem) {
+		return -1;
+	}
+
+	ctx.base = conf->mem;
+	ctx.off = 0;
+	pack_timing(&ctx, src, &conf->timing);
+
+	return 0;
+}
+
+/**
+ * @brief Release a loaded configuration
+ */
+void ddrconf_free(struct ddrconf *conf) {
+	if (!conf) {
+		return;
+	}
+
+	free(conf->mem);
+	if (conf->map) {
+		munmap(conf->map, conf->map_size);
+	}
+	memset(conf, 0, sizeof(*conf));
+}
+
+/**
+ * @brief Read a whole file into memory
+ *
+ * @param path File to read
+ * @param size Output: number of bytes read (optional)
+ * @return NUL-terminated buffer to be released with free(), NULL on error
+ */
+char *ddrconf_read_file(const char *path, size_t *size) {
+	struct stat st;
+	char *buf;
+	size_t done = 0;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		return NULL;
+	}
+
+	if (fstat(fd, &st) != 0) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		close(fd);
+		return NULL;
+	}
+
+	buf = malloc((size_t)st.st_size + 1);
+	if (!buf) {
+		fprintf(stderr, "%s: out of memory\n", path);
+		close(fd);
+		return NULL;
+	}
+
+	while (done < (size_t)st.st_size) {
+		ssize_t n = read(fd, buf + done, (size_t)st.st_size - done);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			fprintf(stderr, "%s: short read\n", path);
+			free(buf);
+			close(fd);
+			return NULL;
+		}
+		done += (size_t)n;
+	}
+
+	close(fd);
+	buf[done] = '\0';
+	if (size) *size = done;
+
+	return buf;
+}
+
+/**
+ * @brief Load a configuration from any supported file type
+ *
+ * @return 0 on success, -1 on error (a message has been printed)
+ */
+int ddrconf_load(const char *path, struct ddrconf *conf) {
+	char head[512];
+	ssize_t n;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		return -1;
+	}
+	n = read(fd, head, sizeof(head) - 1);
+	close(fd);
+	head[n > 0 ? n : 0] = '\0';
+
+	if (n >= (ssize_t)sizeof(DDRSNAP_MAGIC) && memcmp(head, DDRSNAP_MAGIC, sizeof(DDRSNAP_MAGIC)) == 0) {
+		return ddrconf_load_snapshot(path, conf);
+	}
+	if (strstr(head, DDRCONF_DUMP_TITLE)) {
+		return ddrconf_load_dump(path, conf);
+	}
+	/* Sources and dumps are text; anything with a NUL byte is an image */
+	if (n > 0 && memchr(head, '\0', (size_t)n)) {
+		return ddrconf_load_image(path, conf);
+	}
+	if (ddrconf_use_compiler()) {
+		return ddrconf_load_shared(path, conf);
+	}
+
+	return ddrconf_load_source(path, conf);
+}
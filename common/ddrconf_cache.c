@@ -0,0 +1,144 @@
+/**
+ * @file ddrconf_cache.c
+ * @brief Content-hash keyed on-disk cache of parsed timing sources
+ *
+ * A parsed source is stored as a .ddrsnap snapshot named after a hash of
+ * the source bytes, the source size, the snapshot format version and the
+ * parser revision:
+ *
+ *   <cache dir>/<fnv1a-64>-<size>-v<version>-p<revision>.ddrsnap
+ *
+ * Comparing one configuration against many others therefore parses each
+ * distinct file once; unchanged files are mapped straight from the cache
+ * on every later run, and editing a file, or fixing the parser, simply
+ * produces a new key.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "ddrconf.h"
+#include "ddrsnap.h"
+
+static const char *cache_dir;
+
+/**
+ * @brief Enable the parse cache in the given directory (NULL disables it)
+ *
+ * The directory is created on the first store.
+ */
+void ddrconf_set_cache_dir(const char *dir) {
+	cache_dir = (dir && dir[0]) ? dir : NULL;
+}
+
+/**
+ * @brief Currently configured cache directory, NULL if disabled
+ */
+const char *ddrconf_get_cache_dir(void) {
+	return cache_dir;
+}
+
+/**
+ * @brief 64-bit FNV-1a hash of a buffer, used as the cache key
+ */
+unsigned long long ddrconf_hash(const char *buf, size_t size) {
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	for (size_t i = 0; i < size; i++) {
+		hash ^= (unsigned char)buf[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief Build the cache file name for a source buffer
+ *
+ * @return 0 on success, -1 if the cache is disabled or the name is too long
+ */
+static int cache_path(const char *buf, size_t size, char *out, size_t out_size) {
+	int n;
+
+	if (!cache_dir) {
+		return -1;
+	}
+
+	n = snprintf(out, out_size, "%s/%016llx-%08zx-v%u-p%u.ddrsnap", cache_dir,
+	             ddrconf_hash(buf, size), size, DDRSNAP_VERSION, DDRCONF_PARSER_REVISION);
+
+	return (n < 0 || (size_t)n >= out_size) ? -1 : 0;
+}
+
+/**
+ * @brief Create a directory and its missing parents
+ */
+int ddrconf_make_dirs(const char *dir) {
+	char tmp[4096];
+	size_t len = strlen(dir);
+
+	if (len >= sizeof(tmp)) {
+		return -1;
+	}
+	memcpy(tmp, dir, len + 1);
+
+	for (char *c = tmp + 1; *c; c++) {
+		if (*c == '/') {
+			*c = '\0';
+			if (mkdir(tmp, 0777) != 0 && errno != EEXIST) {
+				return -1;
+			}
+			*c = '/';
+		}
+	}
+	if (mkdir(tmp, 0777) != 0 && errno != EEXIST) {
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Look up a previously parsed source in the cache
+ *
+ * @return 0 if conf was loaded from the cache, -1 on a miss
+ */
+int ddrconf_cache_lookup(const char *buf, size_t size, struct ddrconf *conf) {
+	char path[4096];
+
+	if (cache_path(buf, size, path, sizeof(path)) != 0) {
+		return -1;
+	}
+	if (access(path, R_OK) != 0) {
+		return -1;
+	}
+
+	/* A damaged entry is reported by the loader and simply re-parsed */
+	return ddrconf_load_snapshot(path, conf);
+}
+
+/**
+ * @brief Store a freshly parsed source in the cache
+ *
+ * Failures only cost the next run a re-parse, so they are reported as
+ * warnings and otherwise ignored.
+ */
+void ddrconf_cache_store(const char *buf, size_t size, const struct dram_timing_info *timing) {
+	char path[4096];
+
+	if (cache_path(buf, size, path, sizeof(path)) != 0) {
+		return;
+	}
+
+	if (ddrconf_make_dirs(cache_dir) != 0) {
+		fprintf(stderr, "%s: cannot create cache directory: %s\n", cache_dir, strerror(errno));
+		return;
+	}
+
+	ddrconf_write_snapshot(timing, path);
+}
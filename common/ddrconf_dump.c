@@ -0,0 +1,532 @@
+/**
+ * @file ddrconf_dump.c
+ * @brief Reader for ddrconfdump text output
+ *
+ * ddrconfdump prints every register array as
+ *
+ *   <name>
+ *   entries=<n>, size=<bytes> bytes
+ *   crc32=0x<crc>
+ *   [   0]={0x5e080110, 0x41110001}
+ *   ...
+ *
+ * together with a few fsp_cfg[i]/fsp_msg[i] scalars. Such dumps are kept
+ * for field units and releases whose sources are gone, so they can be
+ * loaded as a configuration of their own. The file is streamed line by
+ * line into arrays sized from the entries= headers; the recorded entry
+ * count, size and CRC of every array are verified while reading.
+ *
+ * Fields a dump does not record (ssc, fsp_table, skip_fw, prog_csr and
+ * the prog_csr arrays unless present) are left zero.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+
+#include "ddrconf.h"
+
+/* Highest number of FSPs accepted from a dump */
+#define DUMP_MAX_FSP 16
+
+/* Longest line of a dump, including the newline */
+#define DUMP_MAX_LINE 256
+
+/* Array currently being read */
+struct dump_array {
+	char name[64];
+	struct ddrc_cfg_param **ddrc;   /* destination, for ddrc_cfg_param arrays */
+	struct ddrphy_cfg_param **phy;  /* destination, for ddrphy_cfg_param arrays */
+	unsigned int *num;              /* destination count */
+	unsigned int expected;          /* entries= */
+	uint32_t crc_expected;          /* crc32= */
+	uint32_t crc;                   /* over the entries read so far */
+	int have_entries;
+	int have_crc;
+};
+
+struct dump_reader {
+	const char *path;
+	unsigned int line;
+	struct dram_timing_info timing;
+	struct dram_fsp_cfg fsp_cfg[DUMP_MAX_FSP];
+	struct dram_fsp_msg fsp_msg[DUMP_MAX_FSP];
+	struct dump_array cur;
+	int in_array;
+};
+
+/**
+ * @brief Report an error at the current line
+ */
+static int dump_error(struct dump_reader *r, const char *format, ...)
+	__attribute__((format(printf, 2, 3)));
+
+static int dump_error(struct dump_reader *r, const char *format, ...) {
+	va_list args;
+
+	fprintf(stderr, "%s:%u: ", r->path, r->line);
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+	fprintf(stderr, "\n");
+
+	return -1;
+}
+
+/**
+ * @brief Continue a CRC over more data (same algorithm as ddrconfdump)
+ */
+static uint32_t crc32_update(uint32_t crc, const uint8_t *a, size_t sz) {
+	/* Poly table */
+	static uint32_t const s_crcTable[] = {
+		0x4DBDF21CU, 0x500AE278U, 0x76D3D2D4U, 0x6B64C2B0U,
+		0x3B61B38CU, 0x26D6A3E8U, 0x000F9344U, 0x1DB88320U,
+		0xA005713CU, 0xBDB26158U, 0x9B6B51F4U, 0x86DC4190U,
+		0xD6D930ACU, 0xCB6E20C8U, 0xEDB71064U, 0xF0000000U
+	};
+
+	while (sz > 0U) {
+		crc = (crc >> 4U) ^ s_crcTable[(crc ^ (((uint32_t)(*a)) >> 0U)) & 0x0FU];
+		crc = (crc >> 4U) ^ s_crcTable[(crc ^ (((uint32_t)(*a)) >> 4U)) & 0x0FU];
+		a++;
+		sz--;
+	}
+
+	return crc;
+}
+
+/**
+ * @brief Parse "<prefix>[<index>]." and return the remainder
+ *
+ * @return Member name after the '.', NULL if name has another form
+ */
+static const char *fsp_member(const char *name, const char *prefix, unsigned int *index) {
+	size_t len = strlen(prefix);
+	char *end;
+
+	if (strncmp(name, prefix, len) != 0 || name[len] != '[') {
+		return NULL;
+	}
+	*index = (unsigned int)strtoul(name + len + 1, &end, 10);
+	if (end == name + len + 1 || end[0] != ']' || end[1] != '.') {
+		return NULL;
+	}
+
+	return end + 2;
+}
+
+/**
+ * @brief Find the count field of the array a section header names
+ *
+ * @param ddrc Output: set for ddrc_cfg_param arrays
+ * @param phy Output: set for ddrphy_cfg_param arrays
+ * @return Pointer to the *_num member, NULL for an unknown name
+ */
+static unsigned int *find_array(struct dump_reader *r, const char *name,
+                                struct ddrc_cfg_param ***ddrc,
+                                struct ddrphy_cfg_param ***phy) {
+	struct dram_timing_info *t = &r->timing;
+	const char *member;
+	unsigned int i;
+
+	*ddrc = NULL;
+	*phy = NULL;
+
+	if ((member = fsp_member(name, "fsp_cfg", &i)) != NULL) {
+		if (i >= DUMP_MAX_FSP) {
+			return NULL;
+		}
+		if (i >= t->fsp_cfg_num) t->fsp_cfg_num = i + 1;
+		if (strcmp(member, "ddrc_cfg") == 0) {
+			*ddrc = &r->fsp_cfg[i].ddrc_cfg;
+			return &r->fsp_cfg[i].ddrc_cfg_num;
+		}
+		if (strcmp(member, "mr_cfg") == 0) {
+			*ddrc = &r->fsp_cfg[i].mr_cfg;
+			return &r->fsp_cfg[i].mr_cfg_num;
+		}
+		return NULL;
+	}
+
+	if ((member = fsp_member(name, "fsp_msg", &i)) != NULL) {
+		struct dram_fsp_msg *m;
+
+		if (i >= DUMP_MAX_FSP) {
+			return NULL;
+		}
+		m = &r->fsp_msg[i];
+		if (i >= t->fsp_msg_num) t->fsp_msg_num = i + 1;
+		if (strcmp(member, "fsp_phy_cfg") == 0) {
+			*phy = &m->fsp_phy_cfg;
+			return &m->fsp_phy_cfg_num;
+		}
+		if (strcmp(member, "fsp_phy_msgh_cfg") == 0) {
+			*phy = &m->fsp_phy_msgh_cfg;
+			return &m->fsp_phy_msgh_cfg_num;
+		}
+		if (strcmp(member, "fsp_phy_pie_cfg") == 0) {
+			*phy = &m->fsp_phy_pie_cfg;
+			return &m->fsp_phy_pie_cfg_num;
+		}
+		if (strcmp(member, "fsp_phy_prog_csr_ps_cfg") == 0) {
+			*phy = &m->fsp_phy_prog_csr_ps_cfg;
+			return &m->fsp_phy_prog_csr_ps_cfg_num;
+		}
+		return NULL;
+	}
+
+	if (strcmp(name, "ddrc_cfg") == 0) {
+		*ddrc = &t->ddrc_cfg;
+		return &t->ddrc_cfg_num;
+	}
+	if (strcmp(name, "ddrphy_cfg") == 0) {
+		*phy = &t->ddrphy_cfg;
+		return &t->ddrphy_cfg_num;
+	}
+	if (strcmp(name, "ddrphy_trained_csr") == 0) {
+		*phy = &t->ddrphy_trained_csr;
+		return &t->ddrphy_trained_csr_num;
+	}
+	if (strcmp(name, "ddrphy_pie") == 0) {
+		*phy = &t->ddrphy_pie;
+		return &t->ddrphy_pie_num;
+	}
+	if (strcmp(name, "ddrphy_prog_csr") == 0) {
+		*phy = &t->ddrphy_prog_csr;
+		return &t->ddrphy_prog_csr_num;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Handle a "fsp_cfg[i].bypass=" style scalar line
+ *
+ * @return 1 if the line was a scalar, 0 if not, -1 on error
+ */
+static int read_scalar(struct dump_reader *r, const char *line) {
+	const char *eq = strchr(line, '=');
+	char name[64];
+	const char *member;
+	unsigned long value;
+	unsigned int i;
+	char *end;
+
+	if (!eq || (size_t)(eq - line) >= sizeof(name)) {
+		return 0;
+	}
+	memcpy(name, line, (size_t)(eq - line));
+	name[eq - line] = '\0';
+
+	errno = 0;
+	value = strtoul(eq + 1, &end, 0);
+	if (end == eq + 1 || *end != '\0' || errno) {
+		return dump_error(r, "malformed value '%s'", eq + 1);
+	}
+
+	if ((member = fsp_member(name, "fsp_cfg", &i)) != NULL && i < DUMP_MAX_FSP) {
+		if (strcmp(member, "bypass") != 0) {
+			return dump_error(r, "unknown field '%s'", name);
+		}
+		r->fsp_cfg[i].bypass = (unsigned int)value;
+		if (i >= r->timing.fsp_cfg_num) r->timing.fsp_cfg_num = i + 1;
+		return 1;
+	}
+
+	if ((member = fsp_member(name, "fsp_msg", &i)) != NULL && i < DUMP_MAX_FSP) {
+		if (strcmp(member, "drate") == 0) {
+			r->fsp_msg[i].drate = (unsigned int)value;
+		} else if (strcmp(member, "fw_type") == 0) {
+			r->fsp_msg[i].fw_type = (enum fw_type)value;
+		} else if (strcmp(member, "ssc") == 0) {
+			r->fsp_msg[i].ssc = (value != 0);
+		} else {
+			return dump_error(r, "unknown field '%s'", name);
+		}
+		if (i >= r->timing.fsp_msg_num) r->timing.fsp_msg_num = i + 1;
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Start reading the array named by a section header line
+ */
+static int begin_array(struct dump_reader *r, const char *name) {
+	struct dump_array *a = &r->cur;
+
+	memset(a, 0, sizeof(*a));
+	a->num = find_array(r, name, &a->ddrc, &a->phy);
+	if (!a->num) {
+		return dump_error(r, "unknown array '%s'", name);
+	}
+	if ((a->ddrc && *a->ddrc) || (a->phy && *a->phy)) {
+		return dump_error(r, "array '%s' listed twice", name);
+	}
+	snprintf(a->name, sizeof(a->name), "%s", name);
+	r->in_array = 1;
+
+	return 0;
+}
+
+/**
+ * @brief Read the entries= and crc32= lines of the current array
+ *
+ * @return 1 if the line was consumed, 0 if not a header line, -1 on error
+ */
+static int read_array_header(struct dump_reader *r, const char *line) {
+	struct dump_array *a = &r->cur;
+	size_t elem_size = a->ddrc ? sizeof(struct ddrc_cfg_param) : sizeof(struct ddrphy_cfg_param);
+	unsigned long long size;
+	unsigned long entries;
+	void *data;
+	char *end;
+
+	if (!a->have_entries) {
+		if (strncmp(line, "entries=", 8) != 0) {
+			return dump_error(r, "expected entries= line");
+		}
+		entries = strtoul(line + 8, &end, 10);
+		if (strncmp(end, ", size=", 7) != 0) {
+			return dump_error(r, "malformed entries= line");
+		}
+		size = strtoull(end + 7, &end, 10);
+		if (strcmp(end, " bytes") != 0) {
+			return dump_error(r, "malformed entries= line");
+		}
+		if (entries == 0 || entries > UINT32_MAX / elem_size || size != entries * elem_size) {
+			return dump_error(r, "size %llu does not match %lu entries", size, entries);
+		}
+
+		data = calloc(entries, elem_size);
+		if (!data) {
+			return dump_error(r, "out of memory");
+		}
+		if (a->ddrc) {
+			*a->ddrc = data;
+		} else {
+			*a->phy = data;
+		}
+		a->expected = (unsigned int)entries;
+		a->have_entries = 1;
+		return 1;
+	}
+
+	if (!a->have_crc) {
+		if (strncmp(line, "crc32=", 6) != 0) {
+			return dump_error(r, "expected crc32= line");
+		}
+		a->crc_expected = (uint32_t)strtoul(line + 6, &end, 16);
+		if (end == line + 6 || *end != '\0') {
+			return dump_error(r, "malformed crc32= line");
+		}
+		a->have_crc = 1;
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Read one "[   i]={0xREG, 0xVAL}" entry of the current array
+ */
+static int read_entry(struct dump_reader *r, const char *line) {
+	struct dump_array *a = &r->cur;
+	unsigned long index, reg, val;
+	const char *c = line + 1;
+	char *end;
+
+	while (*c == ' ') c++;
+	index = strtoul(c, &end, 10);
+	if (end == c || strncmp(end, "]={", 3) != 0) {
+		return dump_error(r, "malformed entry");
+	}
+	c = end + 3;
+	reg = strtoul(c, &end, 16);
+	if (end == c || *end != ',') {
+		return dump_error(r, "malformed entry");
+	}
+	c = end + 1;
+	while (*c == ' ') c++;
+	val = strtoul(c, &end, 16);
+	if (end == c || strcmp(end, "}") != 0) {
+		return dump_error(r, "malformed entry");
+	}
+
+	if (index != *a->num) {
+		return dump_error(r, "entry %lu out of sequence (expected %u)", index, *a->num);
+	}
+	if (index >= a->expected) {
+		return dump_error(r, "more entries than the recorded %u", a->expected);
+	}
+
+	if (a->ddrc) {
+		struct ddrc_cfg_param *e = &(*a->ddrc)[index];
+
+		e->reg = (unsigned int)reg;
+		e->val = (unsigned int)val;
+		a->crc = crc32_update(a->crc, (const uint8_t *)e, sizeof(*e));
+	} else {
+		struct ddrphy_cfg_param *e = &(*a->phy)[index];
+
+		if (val > 0xffff) {
+			return dump_error(r, "PHY value 0x%lx exceeds 16 bits", val);
+		}
+		e->reg = (unsigned int)reg;
+		e->val = (unsigned short)val;
+		a->crc = crc32_update(a->crc, (const uint8_t *)e, sizeof(*e));
+	}
+	(*a->num)++;
+
+	return 0;
+}
+
+/**
+ * @brief Check the recorded entry count and CRC of the finished array
+ */
+static int end_array(struct dump_reader *r) {
+	struct dump_array *a = &r->cur;
+
+	r->in_array = 0;
+
+	if (!a->have_crc) {
+		return dump_error(r, "%s: array header is incomplete", a->name);
+	}
+	if (*a->num != a->expected) {
+		return dump_error(r, "%s: %u entries read, %u recorded", a->name, *a->num, a->expected);
+	}
+	if (a->crc != a->crc_expected) {
+		return dump_error(r, "%s: crc32 mismatch (recorded 0x%08x, computed 0x%08x)",
+		                  a->name, a->crc_expected, a->crc);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Process one line, without its line terminator
+ */
+static int read_line(struct dump_reader *r, const char *line) {
+	int ret;
+
+	if (r->in_array) {
+		ret = read_array_header(r, line);
+		if (ret != 0) {
+			return ret < 0 ? -1 : 0;
+		}
+		if (line[0] == '[') {
+			return read_entry(r, line);
+		}
+		if (end_array(r)) {
+			return -1;
+		}
+	}
+
+	/* Blank lines, the box drawing and the centred titles */
+	if (line[0] == '\0' || line[0] == ' ' || (unsigned char)line[0] >= 0x80) {
+		return 0;
+	}
+
+	ret = read_scalar(r, line);
+	if (ret != 0) {
+		return ret < 0 ? -1 : 0;
+	}
+
+	return begin_array(r, line);
+}
+
+/**
+ * @brief Release the arrays allocated while reading
+ */
+static void free_arrays(struct dump_reader *r) {
+	struct dram_timing_info *t = &r->timing;
+
+	free(t->ddrc_cfg);
+	free(t->ddrphy_cfg);
+	free(t->ddrphy_trained_csr);
+	free(t->ddrphy_pie);
+	free(t->ddrphy_prog_csr);
+	for (unsigned int i = 0; i < DUMP_MAX_FSP; i++) {
+		free(r->fsp_cfg[i].ddrc_cfg);
+		free(r->fsp_cfg[i].mr_cfg);
+		free(r->fsp_msg[i].fsp_phy_cfg);
+		free(r->fsp_msg[i].fsp_phy_msgh_cfg);
+		free(r->fsp_msg[i].fsp_phy_pie_cfg);
+		free(r->fsp_msg[i].fsp_phy_prog_csr_ps_cfg);
+	}
+}
+
+/**
+ * @brief Load a configuration from ddrconfdump text output
+ *
+ * @param path Dump file
+ * @param conf Output configuration, released with ddrconf_free()
+ * @return 0 on success, -1 on error (a message has been printed)
+ */
+int ddrconf_load_dump(const char *path, struct ddrconf *conf) {
+	static struct dump_reader zero;
+	struct dump_reader *r;
+	char line[DUMP_MAX_LINE];
+	FILE *f;
+	int ret = -1;
+
+	memset(conf, 0, sizeof(*conf));
+
+	f = fopen(path, "r");
+	if (!f) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	r = malloc(sizeof(*r));
+	if (!r) {
+		fprintf(stderr, "%s: out of memory\n", path);
+		fclose(f);
+		return -1;
+	}
+	*r = zero;
+	r->path = path;
+
+	while (fgets(line, sizeof(line), f)) {
+		size_t len = strlen(line);
+
+		r->line++;
+		if (len == sizeof(line) - 1 && line[len - 1] != '\n') {
+			dump_error(r, "line too long");
+			goto out;
+		}
+		while (len && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+			line[--len] = '\0';
+		}
+		if (read_line(r, line)) {
+			goto out;
+		}
+	}
+	if (ferror(f)) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		goto out;
+	}
+	if (r->in_array && end_array(r)) {
+		goto out;
+	}
+
+	if (r->timing.fsp_cfg_num) r->timing.fsp_cfg = r->fsp_cfg;
+	if (r->timing.fsp_msg_num) r->timing.fsp_msg = r->fsp_msg;
+
+	if (ddrconf_pack(&r->timing, conf)) {
+		fprintf(stderr, "%s: out of memory\n", path);
+		goto out;
+	}
+	ret = 0;
+
+out:
+	free_arrays(r);
+	free(r);
+	fclose(f);
+
+	return ret;
+}
@@ -0,0 +1,451 @@
+/**
+ * @file ddrconf_image.c
+ * @brief Extract the DDR timing tables from a built firmware image
+ *
+ * A firmware image (for example imx-oei) built from lpddr5_timing.c holds
+ * the register arrays and the dram_timing_info / dram_fsp_cfg /
+ * dram_fsp_msg structures that point at them, with addresses relative to
+ * an unknown load address. The image is searched in one pass for two
+ * patterns:
+ *
+ *   - DDRC register records: 32-bit little-endian words 0x5e08xxxx at
+ *     8-byte record stride (struct ddrc_cfg_param);
+ *   - dram_timing_info candidates: words where fsp_cfg_num and fsp_msg_num
+ *     are small and ddrc_cfg_num is plausible, for 32- and 64-bit pointers.
+ *
+ * Each candidate's ddrc_cfg pointer, paired with each DDRC record offset,
+ * gives a load address. A candidate is accepted once every pointer it
+ * holds resolves to records of the right kind inside the image: DDRC
+ * words for ddrc_cfg_param arrays and 20-bit PHY addresses for the packed
+ * 6-byte ddrphy_cfg_param arrays. The arrays are then used straight from
+ * the image, so the result is what actually shipped.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ddrconf.h"
+
+/* Sanity limits for dram_timing_info candidates */
+#define IMAGE_MAX_FSP      16
+#define IMAGE_MAX_ENTRIES  65536
+
+/* DDRC register block: 0x5e080000 - 0x5e08ffff */
+#define DDRC_REG_MASK      0xffff0000U
+#define DDRC_REG_BASE      0x5e080000U
+
+/* PHY registers are 20-bit addresses */
+#define PHY_REG_LIMIT      0x100000U
+
+struct image {
+	const char *path;
+	const uint8_t *data;
+	size_t size;
+	unsigned int ptr_size;   /* 4 or 8 */
+	uint64_t base;           /* load address of data[0] */
+	uint32_t *ddrc_offs;     /* offsets of DDRC register records */
+	size_t num_ddrc_offs;
+};
+
+/* Sequential little-endian reader laid out like the target's C structs */
+struct image_cursor {
+	const struct image *img;
+	size_t off;
+	int bad;
+};
+
+static uint32_t get_le32(const uint8_t *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void cursor_align(struct image_cursor *c, size_t align) {
+	c->off = (c->off + align - 1) & ~(align - 1);
+}
+
+static uint32_t cursor_u32(struct image_cursor *c) {
+	uint32_t v;
+
+	cursor_align(c, 4);
+	if (c->off + 4 > c->img->size) {
+		c->bad = 1;
+		return 0;
+	}
+	v = get_le32(c->img->data + c->off);
+	c->off += 4;
+
+	return v;
+}
+
+static uint8_t cursor_u8(struct image_cursor *c) {
+	if (c->off + 1 > c->img->size) {
+		c->bad = 1;
+		return 0;
+	}
+	return c->img->data[c->off++];
+}
+
+static uint64_t cursor_ptr(struct image_cursor *c) {
+	uint64_t lo, hi = 0;
+
+	cursor_align(c, c->img->ptr_size);
+	lo = cursor_u32(c);
+	if (c->img->ptr_size == 8) {
+		hi = cursor_u32(c);
+	}
+
+	return lo | (hi << 32);
+}
+
+/**
+ * @brief Translate a target address into an image offset
+ *
+ * @return 0 if [ptr, ptr + size) lies inside the image, -1 otherwise
+ */
+static int image_offset(const struct image *img, uint64_t ptr, size_t size, size_t *off) {
+	uint64_t o;
+
+	if (ptr < img->base) {
+		return -1;
+	}
+	o = ptr - img->base;
+	if (o > img->size || size > img->size - o) {
+		return -1;
+	}
+	*off = (size_t)o;
+
+	return 0;
+}
+
+static int is_ddrc_reg(uint32_t reg) {
+	return (reg & DDRC_REG_MASK) == DDRC_REG_BASE;
+}
+
+/**
+ * @brief Resolve a ddrc_cfg_param array pointer
+ *
+ * @return Array inside the image, NULL if it is not made of DDRC records
+ */
+static struct ddrc_cfg_param *resolve_ddrc(const struct image *img, uint64_t ptr, uint32_t num) {
+	size_t off;
+
+	if (num == 0) {
+		return NULL;
+	}
+	if (num > IMAGE_MAX_ENTRIES ||
+	    image_offset(img, ptr, (size_t)num * sizeof(struct ddrc_cfg_param), &off) != 0 ||
+	    off % 4 != 0) {
+		return NULL;
+	}
+	for (uint32_t i = 0; i < num; i++) {
+		if (!is_ddrc_reg(get_le32(img->data + off + i * sizeof(struct ddrc_cfg_param)))) {
+			return NULL;
+		}
+	}
+
+	return (struct ddrc_cfg_param *)(uintptr_t)(img->data + off);
+}
+
+/**
+ * @brief Resolve a packed ddrphy_cfg_param array pointer
+ *
+ * @return Array inside the image, NULL if it is not made of PHY records
+ */
+static struct ddrphy_cfg_param *resolve_phy(const struct image *img, uint64_t ptr, uint32_t num) {
+	size_t off;
+
+	if (num == 0) {
+		return NULL;
+	}
+	if (num > IMAGE_MAX_ENTRIES ||
+	    image_offset(img, ptr, (size_t)num * sizeof(struct ddrphy_cfg_param), &off) != 0) {
+		return NULL;
+	}
+	for (uint32_t i = 0; i < num; i++) {
+		if (get_le32(img->data + off + i * sizeof(struct ddrphy_cfg_param)) >= PHY_REG_LIMIT) {
+			return NULL;
+		}
+	}
+
+	return (struct ddrphy_cfg_param *)(uintptr_t)(img->data + off);
+}
+
+/* A pointer/count pair must be both set or both clear, and resolve if set */
+#define RESOLVE(kind, dst, ptr, num) \
+	((dst) = resolve_##kind(img, (ptr), (num)), ((num) == 0) == ((dst) == NULL))
+
+/**
+ * @brief Read the dram_fsp_cfg array of a timing candidate
+ */
+static int read_fsp_cfg(const struct image *img, size_t off, unsigned int num,
+                        struct dram_fsp_cfg *out) {
+	struct image_cursor c = { img, off, 0 };
+
+	for (unsigned int i = 0; i < num; i++) {
+		struct dram_fsp_cfg *f = &out[i];
+		uint64_t ddrc, mr;
+
+		cursor_align(&c, img->ptr_size);
+		ddrc = cursor_ptr(&c);
+		f->ddrc_cfg_num = cursor_u32(&c);
+		mr = cursor_ptr(&c);
+		f->mr_cfg_num = cursor_u32(&c);
+		f->bypass = cursor_u32(&c);
+
+		if (c.bad || !RESOLVE(ddrc, f->ddrc_cfg, ddrc, f->ddrc_cfg_num) ||
+		    !RESOLVE(ddrc, f->mr_cfg, mr, f->mr_cfg_num)) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Read the dram_fsp_msg array of a timing candidate
+ */
+static int read_fsp_msg(const struct image *img, size_t off, unsigned int num,
+                        struct dram_fsp_msg *out) {
+	struct image_cursor c = { img, off, 0 };
+
+	for (unsigned int i = 0; i < num; i++) {
+		struct dram_fsp_msg *m = &out[i];
+		uint64_t cfg, msgh, pie, prog;
+		uint32_t fw_type;
+
+		cursor_align(&c, img->ptr_size);
+		m->drate = cursor_u32(&c);
+		m->ssc = (cursor_u8(&c) != 0);
+		fw_type = cursor_u32(&c);
+		m->fw_type = (enum fw_type)fw_type;
+		cfg = cursor_ptr(&c);
+		m->fsp_phy_cfg_num = cursor_u32(&c);
+		msgh = cursor_ptr(&c);
+		m->fsp_phy_msgh_cfg_num = cursor_u32(&c);
+		pie = cursor_ptr(&c);
+		m->fsp_phy_pie_cfg_num = cursor_u32(&c);
+		prog = cursor_ptr(&c);
+		m->fsp_phy_prog_csr_ps_cfg_num = cursor_u32(&c);
+
+		if (c.bad || fw_type > FW_2D_IMAGE ||
+		    !RESOLVE(phy, m->fsp_phy_cfg, cfg, m->fsp_phy_cfg_num) ||
+		    !RESOLVE(phy, m->fsp_phy_msgh_cfg, msgh, m->fsp_phy_msgh_cfg_num) ||
+		    !RESOLVE(phy, m->fsp_phy_pie_cfg, pie, m->fsp_phy_pie_cfg_num) ||
+		    !RESOLVE(phy, m->fsp_phy_prog_csr_ps_cfg, prog, m->fsp_phy_prog_csr_ps_cfg_num)) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Try to read a dram_timing_info at off with the current base
+ *
+ * @param fsp_cfg Storage for the FSP arrays (IMAGE_MAX_FSP entries)
+ * @param fsp_msg Storage for the FSP arrays (IMAGE_MAX_FSP entries)
+ * @return 0 if every pointer resolved, -1 otherwise
+ */
+static int read_timing(const struct image *img, size_t off, struct dram_timing_info *t,
+                       struct dram_fsp_cfg *fsp_cfg, struct dram_fsp_msg *fsp_msg) {
+	struct image_cursor c = { img, off, 0 };
+	uint64_t ddrc, cfg, phy, msg, trained, pie, prog;
+	size_t cfg_off, msg_off;
+
+	memset(t, 0, sizeof(*t));
+	ddrc = cursor_ptr(&c);
+	t->ddrc_cfg_num = cursor_u32(&c);
+	cfg = cursor_ptr(&c);
+	t->fsp_cfg_num = cursor_u32(&c);
+	phy = cursor_ptr(&c);
+	t->ddrphy_cfg_num = cursor_u32(&c);
+	msg = cursor_ptr(&c);
+	t->fsp_msg_num = cursor_u32(&c);
+	trained = cursor_ptr(&c);
+	t->ddrphy_trained_csr_num = cursor_u32(&c);
+	pie = cursor_ptr(&c);
+	t->ddrphy_pie_num = cursor_u32(&c);
+	for (unsigned int i = 0; i < ARRAY_SIZE(t->fsp_table); i++) {
+		t->fsp_table[i] = cursor_u32(&c);
+	}
+	t->skip_fw = cursor_u32(&c);
+	t->prog_csr = cursor_u32(&c);
+	prog = cursor_ptr(&c);
+	t->ddrphy_prog_csr_num = cursor_u32(&c);
+
+	if (c.bad || t->fsp_cfg_num > IMAGE_MAX_FSP || t->fsp_msg_num > IMAGE_MAX_FSP ||
+	    t->ddrphy_cfg_num == 0) {
+		return -1;
+	}
+
+	if (!RESOLVE(ddrc, t->ddrc_cfg, ddrc, t->ddrc_cfg_num) ||
+	    !RESOLVE(phy, t->ddrphy_cfg, phy, t->ddrphy_cfg_num) ||
+	    !RESOLVE(phy, t->ddrphy_trained_csr, trained, t->ddrphy_trained_csr_num) ||
+	    !RESOLVE(phy, t->ddrphy_pie, pie, t->ddrphy_pie_num) ||
+	    !RESOLVE(phy, t->ddrphy_prog_csr, prog, t->ddrphy_prog_csr_num)) {
+		return -1;
+	}
+
+	if (t->fsp_cfg_num) {
+		if (image_offset(img, cfg, 1, &cfg_off) != 0 ||
+		    read_fsp_cfg(img, cfg_off, t->fsp_cfg_num, fsp_cfg) != 0) {
+			return -1;
+		}
+		t->fsp_cfg = fsp_cfg;
+	}
+	if (t->fsp_msg_num) {
+		if (image_offset(img, msg, 1, &msg_off) != 0 ||
+		    read_fsp_msg(img, msg_off, t->fsp_msg_num, fsp_msg) != 0) {
+			return -1;
+		}
+		t->fsp_msg = fsp_msg;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Whether the words at off could start a dram_timing_info
+ *
+ * Cheap filter applied at every aligned offset before any pointer is
+ * followed: a non-NULL ddrc_cfg, plausible DDRC and FSP counts and at
+ * least one FSP training message, which every real configuration has.
+ */
+static int timing_candidate(const struct image *img, size_t off) {
+	const unsigned int p = img->ptr_size;
+	const size_t pair = 2 * p;    /* pointer + count, padded */
+	uint32_t ddrc_num, fsp_cfg_num, fsp_msg_num;
+
+	if (off + 4 * pair > img->size) {
+		return 0;
+	}
+
+	ddrc_num = get_le32(img->data + off + p);
+	fsp_cfg_num = get_le32(img->data + off + pair + p);
+	fsp_msg_num = get_le32(img->data + off + 3 * pair + p);
+
+	return ddrc_num > 0 && ddrc_num <= IMAGE_MAX_ENTRIES &&
+	       fsp_cfg_num <= IMAGE_MAX_FSP && fsp_msg_num > 0 && fsp_msg_num <= IMAGE_MAX_FSP &&
+	       get_le32(img->data + off) != 0;
+}
+
+/**
+ * @brief Collect the offsets of all DDRC register records
+ */
+static int index_ddrc_records(struct image *img) {
+	size_t cap = 0;
+
+	for (size_t off = 0; off + sizeof(struct ddrc_cfg_param) <= img->size; off += 4) {
+		if (!is_ddrc_reg(get_le32(img->data + off))) {
+			continue;
+		}
+		if (img->num_ddrc_offs == cap) {
+			uint32_t *grown;
+
+			cap = cap ? cap * 2 : 256;
+			grown = realloc(img->ddrc_offs, cap * sizeof(*grown));
+			if (!grown) {
+				return -1;
+			}
+			img->ddrc_offs = grown;
+		}
+		img->ddrc_offs[img->num_ddrc_offs++] = (uint32_t)off;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Search the image for a dram_timing_info whose pointers all resolve
+ *
+ * @return 0 if found, -1 otherwise
+ */
+static int find_timing(struct image *img, struct dram_timing_info *t,
+                       struct dram_fsp_cfg *fsp_cfg, struct dram_fsp_msg *fsp_msg) {
+	static const unsigned int ptr_sizes[] = { 4, 8 };
+
+	for (unsigned int s = 0; s < ARRAY_SIZE(ptr_sizes); s++) {
+		img->ptr_size = ptr_sizes[s];
+
+		for (size_t off = 0; off < img->size; off += img->ptr_size) {
+			uint64_t ddrc_ptr;
+
+			if (!timing_candidate(img, off)) {
+				continue;
+			}
+			ddrc_ptr = get_le32(img->data + off);
+			if (img->ptr_size == 8) {
+				ddrc_ptr |= (uint64_t)get_le32(img->data + off + 4) << 32;
+			}
+
+			/* Every DDRC record is a possible start of ddrc_cfg */
+			for (size_t i = 0; i < img->num_ddrc_offs; i++) {
+				if (ddrc_ptr < img->ddrc_offs[i]) {
+					continue;
+				}
+				img->base = ddrc_ptr - img->ddrc_offs[i];
+				if (read_timing(img, off, t, fsp_cfg, fsp_msg) == 0) {
+					return 0;
+				}
+			}
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * @brief Load the timing tables embedded in a firmware image
+ *
+ * @param path Raw or ELF firmware image
+ * @param conf Output configuration, released with ddrconf_free()
+ * @return 0 on success, -1 on error (a message has been printed)
+ */
+int ddrconf_load_image(const char *path, struct ddrconf *conf) {
+	struct dram_fsp_cfg fsp_cfg[IMAGE_MAX_FSP];
+	struct dram_fsp_msg fsp_msg[IMAGE_MAX_FSP];
+	struct dram_timing_info timing;
+	struct image img;
+	char *buf;
+	size_t size;
+	int ret = -1;
+
+	memset(conf, 0, sizeof(*conf));
+
+	buf = ddrconf_read_file(path, &size);
+	if (!buf) {
+		return -1;
+	}
+
+	memset(&img, 0, sizeof(img));
+	img.path = path;
+	img.data = (const uint8_t *)buf;
+	img.size = size;
+
+	if (index_ddrc_records(&img) != 0) {
+		fprintf(stderr, "%s: out of memory\n", path);
+		goto out;
+	}
+	if (img.num_ddrc_offs == 0) {
+		fprintf(stderr, "%s: no DDRC register table found\n", path);
+		goto out;
+	}
+	if (find_timing(&img, &timing, fsp_cfg, fsp_msg) != 0) {
+		fprintf(stderr, "%s: %zu DDRC register records found, but no dram_timing_info "
+		        "referring to them\n", path, img.num_ddrc_offs);
+		goto out;
+	}
+
+	if (ddrconf_pack(&timing, conf) != 0) {
+		fprintf(stderr, "%s: out of memory\n", path);
+		goto out;
+	}
+	ret = 0;
+
+out:
+	free(img.ddrc_offs);
+	free(buf);
+
+	return ret;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file ddrconf_readback.c
+ * @brief Streaming reader for register readback logs
+ *
+ * Board bring-up scripts capture live register contents with memtool or
+ * devmem, often across hundreds of boot loops, giving logs of millions of
+ * lines such as
+ *
+ *   0x5E080110:  41110001 00000000 00000000 00000000     (memtool -32)
+ *   0x5e080110: 0x41110001                               (devmem wrappers)
+ *   0x5e080110 = 0x41110001
+ *
+ * Every line starting with a hexadecimal address followed by ':', '=' or
+ * blanks and one or more hexadecimal values is a readback; the n-th value
+ * on a line belongs to address + 4 * n. Anything else (banners, prompts,
+ * "Reading 0x4 count starting at ..." and boot messages) is skipped.
+ *
+ * The log is read line by line and each readback is handed to a callback,
+ * so memory use does not depend on the size of the log.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include "ddrconf.h"
+
+/* Longest line considered, including the newline; longer lines are skipped */
+#define READBACK_MAX_LINE 512
+
+/**
+ * @brief Value of a hexadecimal digit, -1 for any other character
+ */
+static int hex_value(char c) {
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+/**
+ * @brief Parse a 32-bit hexadecimal number with optional 0x prefix
+ *
+ * @return Pointer past the number, NULL if there is none or it is too long
+ */
+static const char *parse_hex(const char *c, uint32_t *val) {
+	uint32_t v = 0;
+	int digits = 0;
+	int d;
+
+	if (c[0] == '0' && (c[1] == 'x' || c[1] == 'X') && hex_value(c[2]) >= 0) {
+		c += 2;
+	}
+	while ((d = hex_value(*c)) >= 0) {
+		if (++digits > 8) {
+			return NULL;
+		}
+		v = (v << 4) | (uint32_t)d;
+		c++;
+	}
+	if (!digits) {
+		return NULL;
+	}
+
+	*val = v;
+	return c;
+}
+
+static const char *skip_blank(const char *c) {
+	while (*c == ' ' || *c == '\t') {
+		c++;
+	}
+	return c;
+}
+
+static int is_line_end(char c) {
+	return c == '\0' || c == '\n' || c == '\r';
+}
+
+/**
+ * @brief Hand every readback on one line to the callback
+ *
+ * @return 0 to continue, the callback's non-zero value to stop
+ */
+static int read_line(const char *line, unsigned long lineno,
+                     ddrconf_readback_fn fn, void *ctx) {
+	const char *c = skip_blank(line);
+	const char *next;
+	uint32_t addr, val;
+	int sep = 0;
+	int ret;
+
+	c = parse_hex(c, &addr);
+	if (!c) {
+		return 0;
+	}
+	if (*c == ':' || *c == '=') {
+		c++;
+		sep = 1;
+	}
+	if (*c != ' ' && *c != '\t' && !sep) {
+		return 0;
+	}
+
+	/* Validate the whole line first, so text after an address is not data */
+	next = skip_blank(c);
+	if (is_line_end(*next)) {
+		return 0;
+	}
+	while (!is_line_end(*next)) {
+		next = parse_hex(next, &val);
+		if (!next || (!is_line_end(*next) && *next != ' ' && *next != '\t')) {
+			return 0;
+		}
+		next = skip_blank(next);
+	}
+
+	for (c = skip_blank(c); !is_line_end(*c); c = skip_blank(c), addr += 4) {
+		c = parse_hex(c, &val);
+		ret = fn(ctx, addr, val, lineno);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Stream a readback log through a callback
+ *
+ * @param path Log file, "-" for standard input
+ * @param fn   Called with every (address, value) read back and its line
+ * @param ctx  Passed through to fn
+ * @return 0 on success, -1 on a read error (a message has been printed),
+ *         or the first non-zero value returned by fn
+ */
+int ddrconf_read_readback(const char *path, ddrconf_readback_fn fn, void *ctx) {
+	char line[READBACK_MAX_LINE];
+	unsigned long lineno = 0;
+	int overlong = 0;
+	FILE *f;
+	int ret = 0;
+
+	f = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+	if (!f) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), f)) {
+		size_t len = strlen(line);
+		int complete = len > 0 && line[len - 1] == '\n';
+
+		/* The tail of an overlong line is not the start of a new one */
+		if (!overlong) {
+			lineno++;
+			if (complete || feof(f)) {
+				ret = read_line(line, lineno, fn, ctx);
+				if (ret) {
+					break;
+				}
+			}
+		}
+		overlong = !complete;
+	}
+	if (!ret && ferror(f)) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		ret = -1;
+	}
+
+	if (f != stdin) {
+		fclose(f);
+	}
+
+	return ret;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file ddrconf_shared.c
+ * @brief Load timing sources by compiling them into shared objects
+ *
+ * As an alternative to the runtime parser, a lpddr5_timing.c source can be
+ * compiled once with the system C compiler into a shared object exporting
+ * its dram_timing symbol, which is then dlopen()ed. This gives exactly the
+ * C semantics of the initializers. Objects are keyed by a hash of the
+ * source contents, so every distinct file is compiled only once:
+ *
+ *   <cache dir>/<fnv1a-64>-<size>.so            with a cache directory
+ *   <source>.<fnv1a-64>-<size>.so               otherwise, next to the source
+ *
+ * The arrays are copied out with ddrconf_pack(), so the object is closed
+ * again before returning.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "ddrconf.h"
+
+/* Directory holding ddr.h, baked in by the Makefile */
+#ifndef DDRCONF_INCLUDE_DIR
+#define DDRCONF_INCLUDE_DIR "../include"
+#endif
+
+static const char *compiler;
+
+/**
+ * @brief Load sources through compiled shared objects (NULL disables)
+ *
+ * @param cc Compiler command, e.g. "cc" or the value of $CC
+ */
+void ddrconf_set_compiler(const char *cc) {
+	compiler = (cc && cc[0]) ? cc : NULL;
+}
+
+/**
+ * @brief Whether sources are loaded through compiled shared objects
+ */
+int ddrconf_use_compiler(void) {
+	return compiler != NULL;
+}
+
+/**
+ * @brief Build the shared object name for a source
+ */
+static int shared_path(const char *path, const char *buf, size_t size,
+                       char *out, size_t out_size) {
+	const char *dir = ddrconf_get_cache_dir();
+	unsigned long long hash = ddrconf_hash(buf, size);
+	int n;
+
+	if (dir) {
+		n = snprintf(out, out_size, "%s/%016llx-%08zx.so", dir, hash, size);
+	} else {
+		/* A name without '/' would make dlopen() search the library path */
+		n = snprintf(out, out_size, "%s%s.%016llx-%08zx.so",
+		             strchr(path, '/') ? "" : "./", path, hash, size);
+	}
+
+	return (n < 0 || (size_t)n >= out_size) ? -1 : 0;
+}
+
+/**
+ * @brief Compile a source into a shared object
+ *
+ * The object is written to a unique temporary name and renamed, so
+ * concurrent compiles, in this or another process, never dlopen() a
+ * half-written file or rename each other's output away.
+ */
+static int compile_shared(const char *path, const char *so_path) {
+	char tmp[4096];
+	pid_t pid;
+	int status;
+	int fd;
+
+	if (snprintf(tmp, sizeof(tmp), "%s.XXXXXX", so_path) >= (int)sizeof(tmp)) {
+		fprintf(stderr, "%s: path too long\n", so_path);
+		return -1;
+	}
+	fd = mkstemp(tmp);
+	if (fd < 0) {
+		fprintf(stderr, "%s: %s\n", tmp, strerror(errno));
+		return -1;
+	}
+	fchmod(fd, 0644);
+	close(fd);
+
+	pid = fork();
+	if (pid < 0) {
+		fprintf(stderr, "%s: fork: %s\n", path, strerror(errno));
+		unlink(tmp);
+		return -1;
+	}
+	if (pid == 0) {
+		execlp(compiler, compiler, "-shared", "-fPIC", "-O0", "-w",
+		       "-I" DDRCONF_INCLUDE_DIR, "-o", tmp, path, (char *)NULL);
+		fprintf(stderr, "%s: %s\n", compiler, strerror(errno));
+		_exit(127);
+	}
+
+	while (waitpid(pid, &status, 0) < 0) {
+		if (errno != EINTR) {
+			fprintf(stderr, "%s: waitpid: %s\n", path, strerror(errno));
+			unlink(tmp);
+			return -1;
+		}
+	}
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		fprintf(stderr, "%s: compilation failed\n", path);
+		unlink(tmp);
+		return -1;
+	}
+
+	if (rename(tmp, so_path) != 0) {
+		int err = errno;
+
+		unlink(tmp);
+		/* A concurrent compile of the same source got there first */
+		if (access(so_path, R_OK) != 0) {
+			fprintf(stderr, "%s: %s\n", so_path, strerror(err));
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Load a timing source through its compiled shared object
+ *
+ * @param path Path to lpddr5_timing.c
+ * @param conf Output configuration, released with ddrconf_free()
+ * @return 0 on success, -1 on error (a message has been printed)
+ */
+int ddrconf_load_shared(const char *path, struct ddrconf *conf) {
+	const struct dram_timing_info *timing;
+	char so_path[4096];
+	const char *dir;
+	char *buf;
+	size_t size;
+	void *handle;
+	int ret = -1;
+
+	memset(conf, 0, sizeof(*conf));
+
+	if (!compiler) {
+		fprintf(stderr, "%s: no compiler configured\n", path);
+		return -1;
+	}
+
+	buf = ddrconf_read_file(path, &size);
+	if (!buf) {
+		return -1;
+	}
+	if (shared_path(path, buf, size, so_path, sizeof(so_path)) != 0) {
+		fprintf(stderr, "%s: path too long\n", path);
+		free(buf);
+		return -1;
+	}
+	free(buf);
+
+	dir = ddrconf_get_cache_dir();
+	if (dir && ddrconf_make_dirs(dir) != 0) {
+		fprintf(stderr, "%s: cannot create cache directory: %s\n", dir, strerror(errno));
+		return -1;
+	}
+
+	if (access(so_path, R_OK) != 0 && compile_shared(path, so_path) != 0) {
+		return -1;
+	}
+
+	handle = dlopen(so_path, RTLD_NOW | RTLD_LOCAL);
+	if (!handle) {
+		fprintf(stderr, "%s: %s\n", so_path, dlerror());
+		return -1;
+	}
+
+	timing = dlsym(handle, "dram_timing");
+	if (!timing) {
+		fprintf(stderr, "%s: no dram_timing symbol\n", so_path);
+	} else if (ddrconf_pack(timing, conf) != 0) {
+		fprintf(stderr, "%s: out of memory\n", path);
+	} else {
+		ret = 0;
+	}
+
+	dlclose(handle);
+
+	return ret;
+}
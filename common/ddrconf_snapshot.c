@@ -0,0 +1,453 @@
+/**
+ * @file ddrconf_snapshot.c
+ * @brief Reader and writer for .ddrsnap binary configuration snapshots
+ *
+ * See ddrsnap.h for the file layout. Loading a snapshot maps the file
+ * read-only and points the dram_timing_info arrays into the mapping; only
+ * the small fsp_cfg/fsp_msg tables are rebuilt on the heap.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "ddrconf.h"
+#include "ddrsnap.h"
+
+/* Upper bound on the number of FSP entries accepted from a snapshot */
+#define SNAP_MAX_FSP 16
+
+/* One array referenced from a dram_timing_info */
+struct snap_slot {
+	const void *ptr;
+	unsigned int num;
+	size_t elem_size;
+};
+
+static int array_is_per_fsp_cfg(uint32_t id) {
+	return id == DDRSNAP_FSP_DDRC_CFG || id == DDRSNAP_FSP_MR_CFG;
+}
+
+static int array_is_per_fsp_msg(uint32_t id) {
+	return id >= DDRSNAP_FSP_PHY_CFG && id <= DDRSNAP_FSP_PHY_PROG_CSR_PS_CFG;
+}
+
+/**
+ * @brief Look up the array with the given id/index in a timing description
+ *
+ * @return 0 on success, -1 if id or index is out of range
+ */
+static int slot_get(const struct dram_timing_info *t, uint32_t id, uint32_t index,
+                    struct snap_slot *slot) {
+	const size_t ddrc = sizeof(struct ddrc_cfg_param);
+	const size_t ddrphy = sizeof(struct ddrphy_cfg_param);
+
+	if (array_is_per_fsp_cfg(id) && index >= t->fsp_cfg_num) return -1;
+	if (array_is_per_fsp_msg(id) && index >= t->fsp_msg_num) return -1;
+
+	switch (id) {
+		case DDRSNAP_DDRC_CFG:
+			*slot = (struct snap_slot){ t->ddrc_cfg, t->ddrc_cfg_num, ddrc };
+			break;
+		case DDRSNAP_FSP_DDRC_CFG:
+			*slot = (struct snap_slot){ t->fsp_cfg[index].ddrc_cfg,
+			                            t->fsp_cfg[index].ddrc_cfg_num, ddrc };
+			break;
+		case DDRSNAP_FSP_MR_CFG:
+			*slot = (struct snap_slot){ t->fsp_cfg[index].mr_cfg,
+			                            t->fsp_cfg[index].mr_cfg_num, ddrc };
+			break;
+		case DDRSNAP_DDRPHY_CFG:
+			*slot = (struct snap_slot){ t->ddrphy_cfg, t->ddrphy_cfg_num, ddrphy };
+			break;
+		case DDRSNAP_FSP_PHY_CFG:
+			*slot = (struct snap_slot){ t->fsp_msg[index].fsp_phy_cfg,
+			                            t->fsp_msg[index].fsp_phy_cfg_num, ddrphy };
+			break;
+		case DDRSNAP_FSP_PHY_MSGH_CFG:
+			*slot = (struct snap_slot){ t->fsp_msg[index].fsp_phy_msgh_cfg,
+			                            t->fsp_msg[index].fsp_phy_msgh_cfg_num, ddrphy };
+			break;
+		case DDRSNAP_FSP_PHY_PIE_CFG:
+			*slot = (struct snap_slot){ t->fsp_msg[index].fsp_phy_pie_cfg,
+			                            t->fsp_msg[index].fsp_phy_pie_cfg_num, ddrphy };
+			break;
+		case DDRSNAP_FSP_PHY_PROG_CSR_PS_CFG:
+			*slot = (struct snap_slot){ t->fsp_msg[index].fsp_phy_prog_csr_ps_cfg,
+			                            t->fsp_msg[index].fsp_phy_prog_csr_ps_cfg_num, ddrphy };
+			break;
+		case DDRSNAP_DDRPHY_TRAINED_CSR:
+			*slot = (struct snap_slot){ t->ddrphy_trained_csr, t->ddrphy_trained_csr_num, ddrphy };
+			break;
+		case DDRSNAP_DDRPHY_PIE:
+			*slot = (struct snap_slot){ t->ddrphy_pie, t->ddrphy_pie_num, ddrphy };
+			break;
+		case DDRSNAP_DDRPHY_PROG_CSR:
+			*slot = (struct snap_slot){ t->ddrphy_prog_csr, t->ddrphy_prog_csr_num, ddrphy };
+			break;
+		default:
+			return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Point the array with the given id/index at mapped data
+ *
+ * The caller has validated id and index with slot_get().
+ */
+static void slot_set(struct dram_timing_info *t, uint32_t id, uint32_t index,
+                     void *data, unsigned int num) {
+	switch (id) {
+		case DDRSNAP_DDRC_CFG:
+			t->ddrc_cfg = data;
+			t->ddrc_cfg_num = num;
+			break;
+		case DDRSNAP_FSP_DDRC_CFG:
+			t->fsp_cfg[index].ddrc_cfg = data;
+			t->fsp_cfg[index].ddrc_cfg_num = num;
+			break;
+		case DDRSNAP_FSP_MR_CFG:
+			t->fsp_cfg[index].mr_cfg = data;
+			t->fsp_cfg[index].mr_cfg_num = num;
+			break;
+		case DDRSNAP_DDRPHY_CFG:
+			t->ddrphy_cfg = data;
+			t->ddrphy_cfg_num = num;
+			break;
+		case DDRSNAP_FSP_PHY_CFG:
+			t->fsp_msg[index].fsp_phy_cfg = data;
+			t->fsp_msg[index].fsp_phy_cfg_num = num;
+			break;
+		case DDRSNAP_FSP_PHY_MSGH_CFG:
+			t->fsp_msg[index].fsp_phy_msgh_cfg = data;
+			t->fsp_msg[index].fsp_phy_msgh_cfg_num = num;
+			break;
+		case DDRSNAP_FSP_PHY_PIE_CFG:
+			t->fsp_msg[index].fsp_phy_pie_cfg = data;
+			t->fsp_msg[index].fsp_phy_pie_cfg_num = num;
+			break;
+		case DDRSNAP_FSP_PHY_PROG_CSR_PS_CFG:
+			t->fsp_msg[index].fsp_phy_prog_csr_ps_cfg = data;
+			t->fsp_msg[index].fsp_phy_prog_csr_ps_cfg_num = num;
+			break;
+		case DDRSNAP_DDRPHY_TRAINED_CSR:
+			t->ddrphy_trained_csr = data;
+			t->ddrphy_trained_csr_num = num;
+			break;
+		case DDRSNAP_DDRPHY_PIE:
+			t->ddrphy_pie = data;
+			t->ddrphy_pie_num = num;
+			break;
+		case DDRSNAP_DDRPHY_PROG_CSR:
+			t->ddrphy_prog_csr = data;
+			t->ddrphy_prog_csr_num = num;
+			break;
+	}
+}
+
+static uint32_t snap_align(uint32_t off) {
+	return (off + DDRSNAP_ALIGN - 1) & ~(DDRSNAP_ALIGN - 1);
+}
+
+/**
+ * @brief Collect the directory of non-empty arrays of a timing description
+ *
+ * @param dir Output directory (may be NULL to only count)
+ * @return Number of arrays
+ */
+static uint32_t collect_arrays(const struct dram_timing_info *t, struct ddrsnap_array *dir) {
+	uint32_t count = 0;
+
+	for (uint32_t id = DDRSNAP_DDRC_CFG; id <= DDRSNAP_DDRPHY_PROG_CSR; id++) {
+		uint32_t copies = 1;
+
+		if (array_is_per_fsp_cfg(id)) copies = t->fsp_cfg_num;
+		if (array_is_per_fsp_msg(id)) copies = t->fsp_msg_num;
+
+		for (uint32_t index = 0; index < copies; index++) {
+			struct snap_slot slot;
+
+			if (slot_get(t, id, index, &slot) || !slot.ptr || slot.num == 0) {
+				continue;
+			}
+			if (dir) {
+				dir[count].id = id;
+				dir[count].index = index;
+				dir[count].offset = 0;
+				dir[count].num = slot.num;
+			}
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * @brief Write a binary snapshot of a timing description
+ *
+ * The snapshot is written to a unique temporary file that is renamed into
+ * place once complete, so an interrupted or concurrent writer, in this or
+ * another process, never leaves a truncated snapshot.
+ *
+ * @param timing Configuration to store
+ * @param path Output file
+ * @return 0 on success, -1 on error (a message has been printed)
+ */
+int ddrconf_write_snapshot(const struct dram_timing_info *timing, const char *path) {
+	static const unsigned char pad[DDRSNAP_ALIGN] = { 0 };
+	struct ddrsnap_header hdr;
+	struct ddrsnap_array *dir = NULL;
+	char tmp_path[4096];
+	uint32_t num_arrays, off;
+	FILE *f = NULL;
+	int ret = -1;
+	int fd;
+
+	if (snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", path) >= (int)sizeof(tmp_path)) {
+		fprintf(stderr, "%s: path too long\n", path);
+		return -1;
+	}
+
+	num_arrays = collect_arrays(timing, NULL);
+	dir = calloc(num_arrays ? num_arrays : 1, sizeof(*dir));
+	if (!dir) {
+		fprintf(stderr, "%s: out of memory\n", path);
+		return -1;
+	}
+	collect_arrays(timing, dir);
+
+	/* Lay out the data section */
+	off = sizeof(hdr) +
+	      timing->fsp_cfg_num * sizeof(struct ddrsnap_fsp_cfg) +
+	      timing->fsp_msg_num * sizeof(struct ddrsnap_fsp_msg) +
+	      num_arrays * sizeof(struct ddrsnap_array);
+	for (uint32_t i = 0; i < num_arrays; i++) {
+		struct snap_slot slot;
+
+		slot_get(timing, dir[i].id, dir[i].index, &slot);
+		off = snap_align(off);
+		dir[i].offset = off;
+		off += (uint32_t)(slot.num * slot.elem_size);
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, DDRSNAP_MAGIC, sizeof(hdr.magic));
+	hdr.version = DDRSNAP_VERSION;
+	hdr.byte_order = DDRSNAP_BYTE_ORDER;
+	hdr.file_size = off;
+	hdr.num_arrays = num_arrays;
+	hdr.fsp_cfg_num = timing->fsp_cfg_num;
+	hdr.fsp_msg_num = timing->fsp_msg_num;
+	memcpy(hdr.fsp_table, timing->fsp_table, sizeof(hdr.fsp_table));
+	hdr.skip_fw = timing->skip_fw;
+	hdr.prog_csr = timing->prog_csr;
+
+	fd = mkstemp(tmp_path);
+	if (fd < 0) {
+		fprintf(stderr, "%s: %s\n", tmp_path, strerror(errno));
+		goto out;
+	}
+	fchmod(fd, 0644);
+	f = fdopen(fd, "wb");
+	if (!f) {
+		fprintf(stderr, "%s: %s\n", tmp_path, strerror(errno));
+		close(fd);
+		unlink(tmp_path);
+		goto out;
+	}
+
+	fwrite(&hdr, sizeof(hdr), 1, f);
+	for (unsigned int i = 0; i < timing->fsp_cfg_num; i++) {
+		struct ddrsnap_fsp_cfg rec = { timing->fsp_cfg[i].bypass };
+		fwrite(&rec, sizeof(rec), 1, f);
+	}
+	for (unsigned int i = 0; i < timing->fsp_msg_num; i++) {
+		struct ddrsnap_fsp_msg rec = {
+			timing->fsp_msg[i].drate,
+			timing->fsp_msg[i].ssc,
+			(uint32_t)timing->fsp_msg[i].fw_type,
+		};
+		fwrite(&rec, sizeof(rec), 1, f);
+	}
+	fwrite(dir, sizeof(*dir), num_arrays, f);
+
+	off = (uint32_t)ftell(f);
+	for (uint32_t i = 0; i < num_arrays; i++) {
+		struct snap_slot slot;
+
+		slot_get(timing, dir[i].id, dir[i].index, &slot);
+		fwrite(pad, 1, dir[i].offset - off, f);
+		fwrite(slot.ptr, slot.elem_size, slot.num, f);
+		off = dir[i].offset + (uint32_t)(slot.num * slot.elem_size);
+	}
+
+	if (ferror(f) | fclose(f)) {
+		f = NULL;
+		fprintf(stderr, "%s: write failed\n", tmp_path);
+		unlink(tmp_path);
+		goto out;
+	}
+	f = NULL;
+
+	if (rename(tmp_path, path) != 0) {
+		int err = errno;
+
+		unlink(tmp_path);
+		/* A concurrent writer of the same snapshot got there first */
+		if (access(path, R_OK) != 0) {
+			fprintf(stderr, "%s: %s\n", path, strerror(err));
+			goto out;
+		}
+	}
+	ret = 0;
+
+out:
+	if (f) {
+		fclose(f);
+		unlink(tmp_path);
+	}
+	free(dir);
+
+	return ret;
+}
+
+/**
+ * @brief Map a binary snapshot and use its arrays in place
+ *
+ * Every offset and count is validated against the file size before use,
+ * so a damaged or foreign snapshot is rejected instead of read out of
+ * bounds.
+ *
+ * @param path Snapshot file
+ * @param conf Output configuration, released with ddrconf_free()
+ * @return 0 on success, -1 on error (a message has been printed)
+ */
+int ddrconf_load_snapshot(const char *path, struct ddrconf *conf) {
+	const struct ddrsnap_header *hdr;
+	const struct ddrsnap_fsp_cfg *fsp_cfg;
+	const struct ddrsnap_fsp_msg *fsp_msg;
+	const struct ddrsnap_array *dir;
+	struct dram_timing_info *t = &conf->timing;
+	struct stat st;
+	unsigned char *map;
+	size_t size, tables;
+	int fd;
+
+	memset(conf, 0, sizeof(*conf));
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		return -1;
+	}
+	if (fstat(fd, &st) != 0) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		close(fd);
+		return -1;
+	}
+	size = (size_t)st.st_size;
+	if (size < sizeof(*hdr)) {
+		fprintf(stderr, "%s: truncated snapshot\n", path);
+		close(fd);
+		return -1;
+	}
+
+	map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		return -1;
+	}
+	conf->map = map;
+	conf->map_size = size;
+
+	hdr = (const struct ddrsnap_header *)map;
+	if (memcmp(hdr->magic, DDRSNAP_MAGIC, sizeof(hdr->magic)) != 0) {
+		fprintf(stderr, "%s: not a ddrsnap file\n", path);
+		goto err;
+	}
+	if (hdr->version != DDRSNAP_VERSION) {
+		fprintf(stderr, "%s: unsupported snapshot version %u\n", path, hdr->version);
+		goto err;
+	}
+	if (hdr->byte_order != DDRSNAP_BYTE_ORDER) {
+		fprintf(stderr, "%s: snapshot has foreign byte order\n", path);
+		goto err;
+	}
+	if (hdr->file_size != size || hdr->fsp_cfg_num > SNAP_MAX_FSP ||
+	    hdr->fsp_msg_num > SNAP_MAX_FSP) {
+		fprintf(stderr, "%s: corrupt snapshot header\n", path);
+		goto err;
+	}
+
+	tables = sizeof(*hdr) +
+	         (size_t)hdr->fsp_cfg_num * sizeof(*fsp_cfg) +
+	         (size_t)hdr->fsp_msg_num * sizeof(*fsp_msg) +
+	         (size_t)hdr->num_arrays * sizeof(*dir);
+	if (tables > size) {
+		fprintf(stderr, "%s: truncated snapshot\n", path);
+		goto err;
+	}
+	fsp_cfg = (const struct ddrsnap_fsp_cfg *)(map + sizeof(*hdr));
+	fsp_msg = (const struct ddrsnap_fsp_msg *)(fsp_cfg + hdr->fsp_cfg_num);
+	dir = (const struct ddrsnap_array *)(fsp_msg + hdr->fsp_msg_num);
+
+	/* Only the small FSP tables need to live on the heap */
+	conf->mem_size = hdr->fsp_cfg_num * sizeof(struct dram_fsp_cfg) +
+	                 hdr->fsp_msg_num * sizeof(struct dram_fsp_msg);
+	conf->mem = calloc(1, conf->mem_size ? conf->mem_size : 1);
+	if (!conf->mem) {
+		fprintf(stderr, "%s: out of memory\n", path);
+		goto err;
+	}
+
+	memcpy(t->fsp_table, hdr->fsp_table, sizeof(t->fsp_table));
+	t->skip_fw = hdr->skip_fw;
+	t->prog_csr = hdr->prog_csr;
+
+	t->fsp_cfg_num = hdr->fsp_cfg_num;
+	t->fsp_cfg = hdr->fsp_cfg_num ? conf->mem : NULL;
+	for (unsigned int i = 0; i < t->fsp_cfg_num; i++) {
+		t->fsp_cfg[i].bypass = fsp_cfg[i].bypass;
+	}
+
+	t->fsp_msg_num = hdr->fsp_msg_num;
+	t->fsp_msg = hdr->fsp_msg_num ?
+	             (struct dram_fsp_msg *)((struct dram_fsp_cfg *)conf->mem + hdr->fsp_cfg_num) : NULL;
+	for (unsigned int i = 0; i < t->fsp_msg_num; i++) {
+		t->fsp_msg[i].drate = fsp_msg[i].drate;
+		t->fsp_msg[i].ssc = fsp_msg[i].ssc != 0;
+		t->fsp_msg[i].fw_type = (enum fw_type)fsp_msg[i].fw_type;
+	}
+
+	for (uint32_t i = 0; i < hdr->num_arrays; i++) {
+		struct snap_slot slot;
+
+		if (slot_get(t, dir[i].id, dir[i].index, &slot) != 0) {
+			fprintf(stderr, "%s: bad array entry %u\n", path, i);
+			goto err;
+		}
+		if (dir[i].offset < tables || dir[i].offset > size ||
+		    dir[i].offset % DDRSNAP_ALIGN != 0 ||
+		    dir[i].num > (size - dir[i].offset) / slot.elem_size) {
+			fprintf(stderr, "%s: array entry %u out of bounds\n", path, i);
+			goto err;
+		}
+		slot_set(t, dir[i].id, dir[i].index, map + dir[i].offset, dir[i].num);
+	}
+
+	return 0;
+
+err:
+	ddrconf_free(conf);
+	return -1;
+}
@@ -0,0 +1,1227 @@
+/**
+ * @file ddrconf_source.c
+ * @brief Runtime parser for DDR Tool generated lpddr5_timing.c sources
+ *
+ * The generated sources only use a small, regular subset of C:
+ *
+ *   static struct ddrc_cfg_param   <name>[] = { {0xREG, 0xVALU}, ... };
+ *   static struct ddrphy_cfg_param <name>[] = { {0xREG, 0xVAL}, ... };
+ *   static struct dram_fsp_msg     <name>[] = { { .field = value, ... }, ... };
+ *   static struct dram_fsp_cfg     <name>[] = { { .field = value, ... }, ... };
+ *   struct dram_timing_info dram_timing = { .field = value, ... };
+ *
+ * where a value is an integer literal, a previously declared array name,
+ * ARRAY_SIZE(<name>), true/false, an fw_type enumerator or a braced list
+ * (fsp_table). Preprocessor lines and comments are skipped. Anything else
+ * is reported with file and line so that a new DDR Tool output format is
+ * noticed instead of silently misread.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "ddrconf.h"
+
+#define MAX_NAME_LEN 64
+#define MAX_LIST_LEN 4
+
+/* Upper bound on threads used to parse the register arrays of one source */
+#define MAX_PARSE_THREADS 16
+
+enum token_type {
+	TOK_EOF,
+	TOK_IDENT,
+	TOK_NUMBER,
+	TOK_PUNCT,
+};
+
+struct token {
+	enum token_type type;
+	const char *start;
+	size_t len;
+	unsigned long long num;
+	char punct;
+};
+
+/* Kinds of top-level arrays a source can declare */
+enum symbol_type {
+	SYM_DDRC,
+	SYM_DDRPHY,
+	SYM_FSP_CFG,
+	SYM_FSP_MSG,
+};
+
+struct symbol {
+	char name[MAX_NAME_LEN];
+	enum symbol_type type;
+	void *data;
+	unsigned int num;
+};
+
+/* Parsed right-hand side of an initializer */
+enum value_kind {
+	VAL_NUM,
+	VAL_SYM,
+	VAL_LIST,
+};
+
+struct value {
+	enum value_kind kind;
+	unsigned long long num;
+	const struct symbol *sym;
+	unsigned int list[MAX_LIST_LEN];
+	unsigned int list_num;
+};
+
+/* How a struct member is filled from a value */
+enum field_kind {
+	FIELD_U32,
+	FIELD_U16,
+	FIELD_BOOL,
+	FIELD_FW_TYPE,
+	FIELD_U32_LIST,
+	FIELD_PTR,
+};
+
+struct field_desc {
+	const char *name;
+	size_t offset;
+	enum field_kind kind;
+	enum symbol_type ptr_type;  /* FIELD_PTR only */
+};
+
+#define FIELD(type, member, kind) \
+	{ #member, offsetof(struct type, member), kind, SYM_DDRC }
+#define FIELD_P(type, member, sym) \
+	{ #member, offsetof(struct type, member), FIELD_PTR, sym }
+
+/* Member tables are listed in declaration order for positional initializers */
+static const struct field_desc ddrc_fields[] = {
+	FIELD(ddrc_cfg_param, reg, FIELD_U32),
+	FIELD(ddrc_cfg_param, val, FIELD_U32),
+};
+
+static const struct field_desc ddrphy_fields[] = {
+	FIELD(ddrphy_cfg_param, reg, FIELD_U32),
+	FIELD(ddrphy_cfg_param, val, FIELD_U16),
+};
+
+static const struct field_desc fsp_cfg_fields[] = {
+	FIELD_P(dram_fsp_cfg, ddrc_cfg, SYM_DDRC),
+	FIELD(dram_fsp_cfg, ddrc_cfg_num, FIELD_U32),
+	FIELD_P(dram_fsp_cfg, mr_cfg, SYM_DDRC),
+	FIELD(dram_fsp_cfg, mr_cfg_num, FIELD_U32),
+	FIELD(dram_fsp_cfg, bypass, FIELD_U32),
+};
+
+static const struct field_desc fsp_msg_fields[] = {
+	FIELD(dram_fsp_msg, drate, FIELD_U32),
+	FIELD(dram_fsp_msg, ssc, FIELD_BOOL),
+	FIELD(dram_fsp_msg, fw_type, FIELD_FW_TYPE),
+	FIELD_P(dram_fsp_msg, fsp_phy_cfg, SYM_DDRPHY),
+	FIELD(dram_fsp_msg, fsp_phy_cfg_num, FIELD_U32),
+	FIELD_P(dram_fsp_msg, fsp_phy_msgh_cfg, SYM_DDRPHY),
+	FIELD(dram_fsp_msg, fsp_phy_msgh_cfg_num, FIELD_U32),
+	FIELD_P(dram_fsp_msg, fsp_phy_pie_cfg, SYM_DDRPHY),
+	FIELD(dram_fsp_msg, fsp_phy_pie_cfg_num, FIELD_U32),
+	FIELD_P(dram_fsp_msg, fsp_phy_prog_csr_ps_cfg, SYM_DDRPHY),
+	FIELD(dram_fsp_msg, fsp_phy_prog_csr_ps_cfg_num, FIELD_U32),
+};
+
+static const struct field_desc timing_fields[] = {
+	FIELD_P(dram_timing_info, ddrc_cfg, SYM_DDRC),
+	FIELD(dram_timing_info, ddrc_cfg_num, FIELD_U32),
+	FIELD_P(dram_timing_info, fsp_cfg, SYM_FSP_CFG),
+	FIELD(dram_timing_info, fsp_cfg_num, FIELD_U32),
+	FIELD_P(dram_timing_info, ddrphy_cfg, SYM_DDRPHY),
+	FIELD(dram_timing_info, ddrphy_cfg_num, FIELD_U32),
+	FIELD_P(dram_timing_info, fsp_msg, SYM_FSP_MSG),
+	FIELD(dram_timing_info, fsp_msg_num, FIELD_U32),
+	FIELD_P(dram_timing_info, ddrphy_trained_csr, SYM_DDRPHY),
+	FIELD(dram_timing_info, ddrphy_trained_csr_num, FIELD_U32),
+	FIELD_P(dram_timing_info, ddrphy_pie, SYM_DDRPHY),
+	FIELD(dram_timing_info, ddrphy_pie_num, FIELD_U32),
+	FIELD(dram_timing_info, fsp_table, FIELD_U32_LIST),
+	FIELD(dram_timing_info, skip_fw, FIELD_U32),
+	FIELD(dram_timing_info, prog_csr, FIELD_U32),
+	FIELD_P(dram_timing_info, ddrphy_prog_csr, SYM_DDRPHY),
+	FIELD(dram_timing_info, ddrphy_prog_csr_num, FIELD_U32),
+};
+
+/* Per array type: C struct name, element size and member table */
+struct symbol_desc {
+	const char *struct_name;
+	size_t elem_size;
+	const struct field_desc *fields;
+	unsigned int num_fields;
+};
+
+static const struct symbol_desc symbol_descs[] = {
+	[SYM_DDRC]    = { "ddrc_cfg_param", sizeof(struct ddrc_cfg_param),
+	                  ddrc_fields, ARRAY_SIZE(ddrc_fields) },
+	[SYM_DDRPHY]  = { "ddrphy_cfg_param", sizeof(struct ddrphy_cfg_param),
+	                  ddrphy_fields, ARRAY_SIZE(ddrphy_fields) },
+	[SYM_FSP_CFG] = { "dram_fsp_cfg", sizeof(struct dram_fsp_cfg),
+	                  fsp_cfg_fields, ARRAY_SIZE(fsp_cfg_fields) },
+	[SYM_FSP_MSG] = { "dram_fsp_msg", sizeof(struct dram_fsp_msg),
+	                  fsp_msg_fields, ARRAY_SIZE(fsp_msg_fields) },
+};
+
+struct parser {
+	const char *path;
+	const char *cur;
+	const char *end;      /* terminating NUL of the source */
+	unsigned int line;
+	struct token tok;
+	struct symbol *syms;
+	unsigned int num_syms;
+	unsigned int cap_syms;
+	struct dram_timing_info timing;
+	int have_timing;
+};
+
+/* One top-level declaration, as found by index_sections() */
+struct section {
+	const char *start;
+	size_t size;
+	unsigned int line;
+	int parallel;         /* register array, parsed on a worker thread */
+	int ret;              /* result of parse_section() */
+	struct symbol sym;    /* parsed array, moved to the main table */
+};
+
+/**
+ * @brief Report a parse error at the current line
+ */
+static int parse_error(struct parser *p, const char *format, ...)
+	__attribute__((format(printf, 2, 3)));
+
+static int parse_error(struct parser *p, const char *format, ...) {
+	va_list args;
+
+	fprintf(stderr, "%s:%u: ", p->path, p->line);
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+	fprintf(stderr, "\n");
+
+	return -1;
+}
+
+/**
+ * @brief Skip whitespace, comments and preprocessor lines
+ */
+static void skip_blank(struct parser *p) {
+	const char *c = p->cur;
+
+	for (;;) {
+		if (*c == '\n') {
+			p->line++;
+			c++;
+		} else if (isspace((unsigned char)*c)) {
+			c++;
+		} else if (c[0] == '/' && c[1] == '*') {
+			c += 2;
+			while (*c && !(c[0] == '*' && c[1] == '/')) {
+				if (*c == '\n') p->line++;
+				c++;
+			}
+			if (*c) c += 2;
+		} else if (c[0] == '/' && c[1] == '/') {
+			while (*c && *c != '\n') c++;
+		} else if (*c == '#') {
+			/* Preprocessor directive, honouring line continuations */
+			while (*c && *c != '\n') {
+				if (c[0] == '\\' && c[1] == '\n') {
+					p->line++;
+					c++;
+				}
+				c++;
+			}
+		} else {
+			break;
+		}
+	}
+
+	p->cur = c;
+}
+
+/**
+ * @brief Advance to the next token
+ */
+static int next_token(struct parser *p) {
+	const char *c;
+
+	skip_blank(p);
+	c = p->cur;
+	p->tok.start = c;
+
+	if (*c == '\0') {
+		p->tok.type = TOK_EOF;
+		p->tok.len = 0;
+		return 0;
+	}
+
+	if (isalpha((unsigned char)*c) || *c == '_') {
+		while (isalnum((unsigned char)*c) || *c == '_') c++;
+		p->tok.type = TOK_IDENT;
+	} else if (isdigit((unsigned char)*c)) {
+		char *end;
+
+		p->tok.num = strtoull(c, &end, 0);
+		c = end;
+		while (*c == 'u' || *c == 'U' || *c == 'l' || *c == 'L') c++;
+		if (isalnum((unsigned char)*c) || *c == '_') {
+			return parse_error(p, "malformed number");
+		}
+		p->tok.type = TOK_NUMBER;
+	} else {
+		p->tok.type = TOK_PUNCT;
+		p->tok.punct = *c++;
+	}
+
+	p->tok.len = (size_t)(c - p->tok.start);
+	p->cur = c;
+
+	return 0;
+}
+
+static int tok_is_punct(const struct parser *p, char ch) {
+	return p->tok.type == TOK_PUNCT && p->tok.punct == ch;
+}
+
+static int tok_is_ident(const struct parser *p, const char *name) {
+	return p->tok.type == TOK_IDENT && strlen(name) == p->tok.len &&
+	       memcmp(p->tok.start, name, p->tok.len) == 0;
+}
+
+/**
+ * @brief Consume a punctuation token or fail
+ */
+static int expect_punct(struct parser *p, char ch) {
+	if (!tok_is_punct(p, ch)) {
+		return parse_error(p, "expected '%c' near '%.*s'", ch,
+		                   (int)(p->tok.len ? p->tok.len : 1), p->tok.start);
+	}
+	return next_token(p);
+}
+
+/**
+ * @brief Copy the current identifier into a fixed buffer
+ */
+static int take_ident(struct parser *p, char *buf, size_t size) {
+	if (p->tok.type != TOK_IDENT) {
+		return parse_error(p, "expected identifier near '%.*s'",
+		                   (int)(p->tok.len ? p->tok.len : 1), p->tok.start);
+	}
+	if (p->tok.len >= size) {
+		return parse_error(p, "identifier too long");
+	}
+	memcpy(buf, p->tok.start, p->tok.len);
+	buf[p->tok.len] = '\0';
+
+	return next_token(p);
+}
+
+static const struct symbol *find_symbol(const struct parser *p, const char *name) {
+	for (unsigned int i = 0; i < p->num_syms; i++) {
+		if (strcmp(p->syms[i].name, name) == 0) {
+			return &p->syms[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Parse the right-hand side of an initializer
+ */
+static int parse_value(struct parser *p, struct value *v) {
+	char name[MAX_NAME_LEN];
+
+	memset(v, 0, sizeof(*v));
+
+	if (p->tok.type == TOK_NUMBER) {
+		v->kind = VAL_NUM;
+		v->num = p->tok.num;
+		return next_token(p);
+	}
+
+	if (tok_is_punct(p, '{')) {
+		v->kind = VAL_LIST;
+		if (next_token(p)) return -1;
+		while (!tok_is_punct(p, '}')) {
+			if (p->tok.type != TOK_NUMBER) {
+				return parse_error(p, "expected number in list");
+			}
+			if (v->list_num >= MAX_LIST_LEN) {
+				return parse_error(p, "too many list elements");
+			}
+			v->list[v->list_num++] = (unsigned int)p->tok.num;
+			if (next_token(p)) return -1;
+			if (!tok_is_punct(p, ',')) break;
+			if (next_token(p)) return -1;
+		}
+		return expect_punct(p, '}');
+	}
+
+	if (take_ident(p, name, sizeof(name))) {
+		return -1;
+	}
+
+	if (strcmp(name, "ARRAY_SIZE") == 0) {
+		const struct symbol *sym;
+
+		if (expect_punct(p, '(') || take_ident(p, name, sizeof(name)) ||
+		    expect_punct(p, ')')) {
+			return -1;
+		}
+		sym = find_symbol(p, name);
+		if (!sym) {
+			return parse_error(p, "ARRAY_SIZE of unknown array '%s'", name);
+		}
+		v->kind = VAL_NUM;
+		v->num = sym->num;
+	} else if (strcmp(name, "true") == 0 || strcmp(name, "false") == 0) {
+		v->kind = VAL_NUM;
+		v->num = (name[0] == 't');
+	} else if (strcmp(name, "FW_1D_IMAGE") == 0) {
+		v->kind = VAL_NUM;
+		v->num = FW_1D_IMAGE;
+	} else if (strcmp(name, "FW_2D_IMAGE") == 0) {
+		v->kind = VAL_NUM;
+		v->num = FW_2D_IMAGE;
+	} else if (strcmp(name, "NULL") == 0) {
+		v->kind = VAL_NUM;
+		v->num = 0;
+	} else {
+		v->kind = VAL_SYM;
+		v->sym = find_symbol(p, name);
+		if (!v->sym) {
+			return parse_error(p, "reference to unknown array '%s'", name);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Store a parsed value into one struct member
+ */
+static int store_field(struct parser *p, const struct field_desc *f,
+                       const struct value *v, void *base) {
+	unsigned char *dst = (unsigned char *)base + f->offset;
+
+	if (f->kind == FIELD_U32_LIST) {
+		unsigned int list[MAX_LIST_LEN] = { 0 };
+
+		if (v->kind != VAL_LIST) {
+			return parse_error(p, "'%s' expects a braced list", f->name);
+		}
+		memcpy(list, v->list, v->list_num * sizeof(unsigned int));
+		memcpy(dst, list, sizeof(list));
+		return 0;
+	}
+
+	if (f->kind == FIELD_PTR) {
+		void *ptr = NULL;
+
+		if (v->kind == VAL_SYM) {
+			if (v->sym->type != f->ptr_type) {
+				return parse_error(p, "'%s' points to an array of struct %s",
+				                   f->name, symbol_descs[v->sym->type].struct_name);
+			}
+			ptr = v->sym->data;
+		} else if (v->kind != VAL_NUM || v->num != 0) {
+			return parse_error(p, "'%s' expects an array name", f->name);
+		}
+		memcpy(dst, &ptr, sizeof(ptr));
+		return 0;
+	}
+
+	if (v->kind != VAL_NUM) {
+		return parse_error(p, "'%s' expects a number", f->name);
+	}
+
+	switch (f->kind) {
+		case FIELD_U32: {
+			unsigned int u = (unsigned int)v->num;
+			memcpy(dst, &u, sizeof(u));
+			break;
+		}
+		case FIELD_U16: {
+			unsigned short u = (unsigned short)v->num;
+			memcpy(dst, &u, sizeof(u));
+			break;
+		}
+		case FIELD_BOOL: {
+			bool b = (v->num != 0);
+			memcpy(dst, &b, sizeof(b));
+			break;
+		}
+		case FIELD_FW_TYPE: {
+			enum fw_type t = (enum fw_type)v->num;
+			memcpy(dst, &t, sizeof(t));
+			break;
+		}
+		default:
+			return parse_error(p, "internal error: bad field kind");
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Parse one braced struct initializer
+ *
+ * Both positional ({0x10, 0x2}) and designated (.drate = 6400) forms are
+ * accepted. Members that are not mentioned stay zero.
+ */
+static int parse_struct(struct parser *p, const struct field_desc *fields,
+                        unsigned int num_fields, void *base) {
+	unsigned int pos = 0;
+
+	if (expect_punct(p, '{')) {
+		return -1;
+	}
+
+	while (!tok_is_punct(p, '}')) {
+		const struct field_desc *f = NULL;
+		struct value v;
+
+		if (tok_is_punct(p, '.')) {
+			char name[MAX_NAME_LEN];
+
+			if (next_token(p) || take_ident(p, name, sizeof(name))) {
+				return -1;
+			}
+			for (unsigned int i = 0; i < num_fields; i++) {
+				if (strcmp(fields[i].name, name) == 0) {
+					f = &fields[i];
+					pos = i;
+					break;
+				}
+			}
+			if (!f) {
+				return parse_error(p, "unknown member '%s'", name);
+			}
+			if (expect_punct(p, '=')) {
+				return -1;
+			}
+		} else {
+			if (pos >= num_fields) {
+				return parse_error(p, "too many initializers");
+			}
+			f = &fields[pos];
+		}
+
+		if (parse_value(p, &v) || store_field(p, f, &v, base)) {
+			return -1;
+		}
+		pos++;
+
+		if (!tok_is_punct(p, ',')) break;
+		if (next_token(p)) return -1;
+	}
+
+	return expect_punct(p, '}');
+}
+
+/**
+ * @brief Value of a hex digit character, 16 for anything else
+ */
+static inline unsigned int hex_digit(unsigned char c) {
+	if ((unsigned char)(c - '0') < 10) {
+		return c - '0';
+	}
+	c |= 0x20;
+	if ((unsigned char)(c - 'a') < 6) {
+		return c - 'a' + 10;
+	}
+	return 16;
+}
+
+/**
+ * @brief Convert the run of hex digits at c
+ *
+ * On x86 the run is classified and converted 16 characters at a time with
+ * SSE2, which every x86-64 CPU has; other targets use the scalar loop.
+ * Runs longer than 8 digits are left to the generic parser.
+ *
+ * @return Number of digits (0 if none or too many)
+ */
+static unsigned int scan_hex(const char *c, const char *end, unsigned int *val) {
+	unsigned int n = 0;
+	unsigned int v = 0;
+
+#ifdef __SSE2__
+	if (end - c >= 16) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)c);
+		const __m128i lower = _mm_or_si128(in, _mm_set1_epi8(0x20));
+		const __m128i dec = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)),
+		                                  _mm_cmplt_epi8(in, _mm_set1_epi8('9' + 1)));
+		const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+		                                    _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+		const __m128i nibble = _mm_or_si128(
+			_mm_and_si128(dec, _mm_sub_epi8(in, _mm_set1_epi8('0'))),
+			_mm_andnot_si128(dec, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+		unsigned char nibbles[16];
+		unsigned int mask;
+
+		mask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(dec, alpha));
+		n = (unsigned int)__builtin_ctz(~mask);
+		if (n == 0 || n > 8) {
+			return 0;
+		}
+
+		_mm_storeu_si128((__m128i *)nibbles, nibble);
+		for (unsigned int i = 0; i < n; i++) {
+			v = (v << 4) | nibbles[i];
+		}
+		*val = v;
+		return n;
+	}
+#else
+	(void)end;
+#endif
+
+	for (unsigned int d; (d = hex_digit((unsigned char)c[n])) < 16; n++) {
+		if (n == 8) {
+			return 0;
+		}
+		v = (v << 4) | d;
+	}
+	*val = v;
+
+	return n;
+}
+
+/**
+ * @brief Scan one hex literal with optional integer suffix
+ *
+ * @return Position after the literal, NULL if c is not such a literal
+ */
+static const char *scan_hex_literal(const char *c, const char *end, unsigned int *val) {
+	unsigned int n;
+
+	if (c[0] != '0' || (c[1] | 0x20) != 'x') {
+		return NULL;
+	}
+	c += 2;
+	n = scan_hex(c, end, val);
+	if (n == 0) {
+		return NULL;
+	}
+	c += n;
+	while (*c == 'u' || *c == 'U' || *c == 'l' || *c == 'L') c++;
+	if (isalnum((unsigned char)*c) || *c == '_') {
+		return NULL;
+	}
+
+	return c;
+}
+
+/**
+ * @brief Fast path for a {0xREG, 0xVAL} register array element
+ *
+ * Nearly every line of a timing source has this shape. It is recognised
+ * directly from the text, bypassing the tokenizer; anything unusual
+ * (comments, decimal or long literals, designated members, line breaks)
+ * makes it return 0 so that parse_struct() handles the element instead.
+ * The current token must be the element's opening brace.
+ *
+ * @return 1 if the element was parsed, 0 to fall back, -1 on error
+ */
+static int scan_reg_pair(struct parser *p, const struct symbol_desc *desc, void *elem) {
+	const char *c = p->cur;
+	unsigned int reg, val;
+
+	while (*c == ' ' || *c == '\t') c++;
+	c = scan_hex_literal(c, p->end, &reg);
+	if (!c) {
+		return 0;
+	}
+	while (*c == ' ' || *c == '\t') c++;
+	if (*c++ != ',') {
+		return 0;
+	}
+	while (*c == ' ' || *c == '\t') c++;
+	c = scan_hex_literal(c, p->end, &val);
+	if (!c) {
+		return 0;
+	}
+	while (*c == ' ' || *c == '\t') c++;
+	if (*c++ != '}') {
+		return 0;
+	}
+
+	memcpy((unsigned char *)elem + desc->fields[0].offset, &reg, sizeof(reg));
+	if (desc->fields[1].kind == FIELD_U16) {
+		unsigned short u = (unsigned short)val;
+		memcpy((unsigned char *)elem + desc->fields[1].offset, &u, sizeof(u));
+	} else {
+		memcpy((unsigned char *)elem + desc->fields[1].offset, &val, sizeof(val));
+	}
+
+	p->cur = c;
+	return next_token(p) ? -1 : 1;
+}
+
+/**
+ * @brief Parse the braced element list of an array declaration
+ */
+static int parse_array(struct parser *p, struct symbol *sym) {
+	const struct symbol_desc *desc = &symbol_descs[sym->type];
+	unsigned int cap = 0;
+
+	if (expect_punct(p, '{')) {
+		return -1;
+	}
+
+	while (!tok_is_punct(p, '}')) {
+		unsigned char *elem;
+
+		if (sym->num == cap) {
+			void *grown;
+
+			cap = cap ? cap * 2 : 64;
+			grown = realloc(sym->data, cap * desc->elem_size);
+			if (!grown) {
+				return parse_error(p, "out of memory");
+			}
+			sym->data = grown;
+		}
+
+		elem = (unsigned char *)sym->data + sym->num * desc->elem_size;
+		memset(elem, 0, desc->elem_size);
+		if ((sym->type == SYM_DDRC || sym->type == SYM_DDRPHY) && tok_is_punct(p, '{')) {
+			int ret = scan_reg_pair(p, desc, elem);
+
+			if (ret < 0) {
+				return -1;
+			}
+			if (ret > 0) {
+				sym->num++;
+				if (!tok_is_punct(p, ',')) break;
+				if (next_token(p)) return -1;
+				continue;
+			}
+		}
+		if (parse_struct(p, desc->fields, desc->num_fields, elem)) {
+			return -1;
+		}
+		sym->num++;
+
+		if (!tok_is_punct(p, ',')) break;
+		if (next_token(p)) return -1;
+	}
+
+	return expect_punct(p, '}');
+}
+
+/**
+ * @brief Skip an unrecognised declaration up to its terminating ';'
+ */
+static int skip_declaration(struct parser *p) {
+	int depth = 0;
+
+	while (p->tok.type != TOK_EOF) {
+		if (tok_is_punct(p, '{')) depth++;
+		if (tok_is_punct(p, '}')) depth--;
+		if (tok_is_punct(p, ';') && depth == 0) {
+			return next_token(p);
+		}
+		if (next_token(p)) return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Append a zeroed entry to the symbol table
+ */
+static struct symbol *add_symbol(struct parser *p) {
+	struct symbol *sym;
+
+	if (p->num_syms == p->cap_syms) {
+		unsigned int cap = p->cap_syms ? p->cap_syms * 2 : 16;
+		struct symbol *grown = realloc(p->syms, cap * sizeof(*grown));
+
+		if (!grown) {
+			parse_error(p, "out of memory");
+			return NULL;
+		}
+		p->syms = grown;
+		p->cap_syms = cap;
+	}
+
+	sym = &p->syms[p->num_syms++];
+	memset(sym, 0, sizeof(*sym));
+
+	return sym;
+}
+
+/**
+ * @brief Parse one top-level declaration
+ */
+static int parse_declaration(struct parser *p) {
+	char type_name[MAX_NAME_LEN];
+	char name[MAX_NAME_LEN];
+	struct symbol *sym;
+	int sym_type = -1;
+
+	while (tok_is_ident(p, "static") || tok_is_ident(p, "const")) {
+		if (next_token(p)) return -1;
+	}
+
+	if (!tok_is_ident(p, "struct")) {
+		return skip_declaration(p);
+	}
+	if (next_token(p) || take_ident(p, type_name, sizeof(type_name))) {
+		return -1;
+	}
+	while (tok_is_ident(p, "const")) {
+		if (next_token(p)) return -1;
+	}
+	if (take_ident(p, name, sizeof(name))) {
+		return -1;
+	}
+
+	if (strcmp(type_name, "dram_timing_info") == 0) {
+		if (p->have_timing) {
+			return parse_error(p, "more than one dram_timing_info definition");
+		}
+		if (expect_punct(p, '=') ||
+		    parse_struct(p, timing_fields, ARRAY_SIZE(timing_fields), &p->timing) ||
+		    expect_punct(p, ';')) {
+			return -1;
+		}
+		p->have_timing = 1;
+		return 0;
+	}
+
+	for (unsigned int i = 0; i < ARRAY_SIZE(symbol_descs); i++) {
+		if (strcmp(type_name, symbol_descs[i].struct_name) == 0) {
+			sym_type = (int)i;
+			break;
+		}
+	}
+	if (sym_type < 0) {
+		return skip_declaration(p);
+	}
+
+	if (find_symbol(p, name)) {
+		return parse_error(p, "redefinition of '%s'", name);
+	}
+
+	if (expect_punct(p, '[')) {
+		return -1;
+	}
+	if (p->tok.type == TOK_NUMBER && next_token(p)) {
+		return -1;
+	}
+	if (expect_punct(p, ']') || expect_punct(p, '=')) {
+		return -1;
+	}
+
+	sym = add_symbol(p);
+	if (!sym) {
+		return -1;
+	}
+	strcpy(sym->name, name);
+	sym->type = (enum symbol_type)sym_type;
+
+	if (parse_array(p, sym)) {
+		return -1;
+	}
+
+	return expect_punct(p, ';');
+}
+
+/**
+ * @brief Check that an element count does not exceed the referenced array
+ */
+static int check_count(struct parser *p, const char *what, const void *ptr, unsigned int num) {
+	unsigned int avail = 0;
+
+	if (ptr) {
+		for (unsigned int i = 0; i < p->num_syms; i++) {
+			if (p->syms[i].data == ptr) {
+				avail = p->syms[i].num;
+				break;
+			}
+		}
+	}
+
+	if (num > avail) {
+		return parse_error(p, "%s: count %u exceeds array size %u", what, num, avail);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Validate every pointer/count pair reachable from dram_timing
+ */
+static int check_timing(struct parser *p) {
+	const struct dram_timing_info *t = &p->timing;
+	int ret = 0;
+
+	ret |= check_count(p, "ddrc_cfg", t->ddrc_cfg, t->ddrc_cfg_num);
+	ret |= check_count(p, "fsp_cfg", t->fsp_cfg, t->fsp_cfg_num);
+	ret |= check_count(p, "ddrphy_cfg", t->ddrphy_cfg, t->ddrphy_cfg_num);
+	ret |= check_count(p, "fsp_msg", t->fsp_msg, t->fsp_msg_num);
+	ret |= check_count(p, "ddrphy_trained_csr", t->ddrphy_trained_csr, t->ddrphy_trained_csr_num);
+	ret |= check_count(p, "ddrphy_pie", t->ddrphy_pie, t->ddrphy_pie_num);
+	ret |= check_count(p, "ddrphy_prog_csr", t->ddrphy_prog_csr, t->ddrphy_prog_csr_num);
+	if (ret) {
+		return -1;
+	}
+
+	for (unsigned int i = 0; i < t->fsp_cfg_num; i++) {
+		const struct dram_fsp_cfg *c = &t->fsp_cfg[i];
+
+		ret |= check_count(p, "fsp_cfg.ddrc_cfg", c->ddrc_cfg, c->ddrc_cfg_num);
+		ret |= check_count(p, "fsp_cfg.mr_cfg", c->mr_cfg, c->mr_cfg_num);
+	}
+
+	for (unsigned int i = 0; i < t->fsp_msg_num; i++) {
+		const struct dram_fsp_msg *m = &t->fsp_msg[i];
+
+		ret |= check_count(p, "fsp_msg.fsp_phy_cfg", m->fsp_phy_cfg, m->fsp_phy_cfg_num);
+		ret |= check_count(p, "fsp_msg.fsp_phy_msgh_cfg", m->fsp_phy_msgh_cfg,
+		                   m->fsp_phy_msgh_cfg_num);
+		ret |= check_count(p, "fsp_msg.fsp_phy_pie_cfg", m->fsp_phy_pie_cfg,
+		                   m->fsp_phy_pie_cfg_num);
+		ret |= check_count(p, "fsp_msg.fsp_phy_prog_csr_ps_cfg", m->fsp_phy_prog_csr_ps_cfg,
+		                   m->fsp_phy_prog_csr_ps_cfg_num);
+	}
+
+	return ret ? -1 : 0;
+}
+
+/**
+ * @brief Index the top-level declarations of a source
+ *
+ * One pass over the text finds where each declaration starts (and on which
+ * line), honouring comments and preprocessor lines the same way the lexer
+ * does. Register arrays are flagged for parsing on a worker thread.
+ *
+ * @return Number of sections, or -1 on allocation failure
+ */
+static int index_sections(const char *buf, struct section **out) {
+	struct parser s;
+	struct section *secs = NULL;
+	unsigned int num = 0, cap = 0;
+
+	memset(&s, 0, sizeof(s));
+	s.cur = buf;
+	s.line = 1;
+
+	for (;;) {
+		struct section *sec;
+		struct parser hdr;
+		int depth = 0;
+
+		skip_blank(&s);
+		if (*s.cur == '\0') {
+			break;
+		}
+
+		if (num == cap) {
+			struct section *grown;
+
+			cap = cap ? cap * 2 : 32;
+			grown = realloc(secs, cap * sizeof(*grown));
+			if (!grown) {
+				free(secs);
+				return -1;
+			}
+			secs = grown;
+		}
+		sec = &secs[num++];
+		memset(sec, 0, sizeof(*sec));
+		sec->start = s.cur;
+		sec->line = s.line;
+
+		/* Only register arrays are independent of earlier declarations */
+		hdr = s;
+		if (next_token(&hdr) == 0) {
+			while (tok_is_ident(&hdr, "static") || tok_is_ident(&hdr, "const")) {
+				if (next_token(&hdr)) break;
+			}
+			if (tok_is_ident(&hdr, "struct") && next_token(&hdr) == 0) {
+				sec->parallel = tok_is_ident(&hdr, symbol_descs[SYM_DDRC].struct_name) ||
+				                tok_is_ident(&hdr, symbol_descs[SYM_DDRPHY].struct_name);
+			}
+		}
+
+		while (*s.cur) {
+			char ch = *s.cur++;
+
+			if (ch == '{') {
+				depth++;
+			} else if (ch == '}') {
+				depth--;
+			} else if (ch == ';' && depth == 0) {
+				break;
+			}
+			skip_blank(&s);
+		}
+		sec->size = (size_t)(s.cur - sec->start);
+	}
+
+	*out = secs;
+	return (int)num;
+}
+
+/**
+ * @brief Parse one register array section with a private parser
+ *
+ * Runs on a worker thread: nothing outside sec is touched besides stderr.
+ */
+static void parse_section(const char *path, const char *end, struct section *sec) {
+	struct parser p;
+
+	memset(&p, 0, sizeof(p));
+	p.path = path;
+	p.end = end;
+	p.cur = sec->start;
+	p.line = sec->line;
+
+	sec->ret = -1;
+	if (next_token(&p) == 0 && parse_declaration(&p) == 0 && p.num_syms == 1) {
+		sec->sym = p.syms[0];
+		sec->ret = 0;
+	} else {
+		for (unsigned int i = 0; i < p.num_syms; i++) {
+			free(p.syms[i].data);
+		}
+	}
+	free(p.syms);
+}
+
+/* Work queue shared by the section parser threads */
+struct section_pool {
+	const char *path;
+	const char *end;
+	struct section *secs;
+	unsigned int *order;   /* parallel sections, largest first */
+	unsigned int num;
+	unsigned int next;
+	pthread_mutex_t lock;
+};
+
+static void *section_worker(void *arg) {
+	struct section_pool *pool = arg;
+
+	for (;;) {
+		unsigned int i;
+
+		pthread_mutex_lock(&pool->lock);
+		i = pool->next < pool->num ? pool->order[pool->next++] : UINT_MAX;
+		pthread_mutex_unlock(&pool->lock);
+
+		if (i == UINT_MAX) {
+			break;
+		}
+		parse_section(pool->path, pool->end, &pool->secs[i]);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Parse all register array sections, in parallel where possible
+ *
+ * The calling thread takes part in the work, so with a single CPU (or a
+ * failed pthread_create()) everything simply runs inline.
+ */
+static int parse_sections_parallel(const char *path, const char *end,
+                                   struct section *secs, unsigned int num) {
+	pthread_t threads[MAX_PARSE_THREADS];
+	struct section_pool pool;
+	unsigned int num_threads = 0;
+	long cpus;
+
+	memset(&pool, 0, sizeof(pool));
+	pool.path = path;
+	pool.end = end;
+	pool.secs = secs;
+	pool.order = malloc((num ? num : 1) * sizeof(*pool.order));
+	if (!pool.order) {
+		return -1;
+	}
+	/* Hand out the biggest arrays first so they do not finish last */
+	for (unsigned int i = 0; i < num; i++) {
+		unsigned int j;
+
+		if (!secs[i].parallel) {
+			continue;
+		}
+		for (j = pool.num; j > 0 && secs[pool.order[j - 1]].size < secs[i].size; j--) {
+			pool.order[j] = pool.order[j - 1];
+		}
+		pool.order[j] = i;
+		pool.num++;
+	}
+
+	cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cpus > MAX_PARSE_THREADS) {
+		cpus = MAX_PARSE_THREADS;
+	}
+	pthread_mutex_init(&pool.lock, NULL);
+	while ((long)num_threads + 1 < cpus && num_threads + 1 < pool.num) {
+		if (pthread_create(&threads[num_threads], NULL, section_worker, &pool) != 0) {
+			break;
+		}
+		num_threads++;
+	}
+
+	section_worker(&pool);
+	for (unsigned int i = 0; i < num_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	pthread_mutex_destroy(&pool.lock);
+	free(pool.order);
+
+	return 0;
+}
+
+/**
+ * @brief Parse a DDR Tool generated timing source held in memory
+ *
+ * The register arrays make up nearly all of a source and do not refer to
+ * anything else, so they are parsed concurrently. The few aggregate
+ * declarations (dram_fsp_msg, dram_fsp_cfg, dram_timing_info) are then
+ * parsed in file order against the finished arrays.
+ *
+ * @param path File name used in error messages
+ * @param buf NUL-terminated source text
+ * @param conf Output configuration, released with ddrconf_free()
+ * @return 0 on success, -1 on error (a message has been printed)
+ */
+int ddrconf_parse_source(const char *path, const char *buf, struct ddrconf *conf) {
+	struct section *secs = NULL;
+	struct parser p;
+	int num_secs;
+	int ret = -1;
+
+	memset(conf, 0, sizeof(*conf));
+
+	memset(&p, 0, sizeof(p));
+	p.path = path;
+	p.cur = buf;
+	p.end = buf + strlen(buf);
+	p.line = 1;
+
+	num_secs = index_sections(buf, &secs);
+	if (num_secs < 0 ||
+	    parse_sections_parallel(path, p.end, secs, (unsigned int)num_secs)) {
+		fprintf(stderr, "%s: out of memory\n", path);
+		num_secs = 0;
+		goto out;
+	}
+
+	for (int i = 0; i < num_secs; i++) {
+		struct section *sec = &secs[i];
+		struct symbol *sym;
+
+		p.cur = sec->start;
+		p.line = sec->line;
+
+		if (!sec->parallel) {
+			if (next_token(&p) || parse_declaration(&p)) {
+				goto out;
+			}
+			continue;
+		}
+
+		if (sec->ret) {
+			goto out;
+		}
+		if (find_symbol(&p, sec->sym.name)) {
+			parse_error(&p, "redefinition of '%s'", sec->sym.name);
+			goto out;
+		}
+		sym = add_symbol(&p);
+		if (!sym) {
+			goto out;
+		}
+		*sym = sec->sym;
+		sec->sym.data = NULL;
+	}
+
+	if (!p.have_timing) {
+		parse_error(&p, "no struct dram_timing_info definition found");
+		goto out;
+	}
+
+	if (check_timing(&p)) {
+		goto out;
+	}
+
+	if (ddrconf_pack(&p.timing, conf)) {
+		fprintf(stderr, "%s: out of memory\n", path);
+		goto out;
+	}
+	ret = 0;
+
+out:
+	for (int i = 0; i < num_secs; i++) {
+		free(secs[i].sym.data);
+	}
+	free(secs);
+	for (unsigned int i = 0; i < p.num_syms; i++) {
+		free(p.syms[i].data);
+	}
+	free(p.syms);
+
+	return ret;
+}
+
+/**
+ * @brief Load a DDR Tool generated timing source
+ *
+ * When a cache directory is configured (ddrconf_set_cache_dir()) the
+ * parsed result is looked up by content hash first and stored after a
+ * successful parse.
+ *
+ * @param path Path to lpddr5_timing.c
+ * @param conf Output configuration, released with ddrconf_free()
+ * @return 0 on success, -1 on error (a message has been printed)
+ */
+int ddrconf_load_source(const char *path, struct ddrconf *conf) {
+	char *buf;
+	size_t size;
+	int ret;
+
+	memset(conf, 0, sizeof(*conf));
+
+	buf = ddrconf_read_file(path, &size);
+	if (!buf) {
+		return -1;
+	}
+
+	if (ddrconf_cache_lookup(buf, size, conf) == 0) {
+		free(buf);
+		return 0;
+	}
+
+	ret = ddrconf_parse_source(path, buf, conf);
+	if (ret == 0) {
+		ddrconf_cache_store(buf, size, &conf->timing);
+	}
+	free(buf);
+
+	return ret;
+}
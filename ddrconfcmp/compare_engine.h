@@ -0,0 +1,874 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright 2025 Variscite Ltd.
+ *
+ * Register table comparison engine, instantiated once per table type.
+ *
+ * DDRC and DDRPHY tables are compared, reordered, split into common and
+ * unique registers and checked for duplicates in exactly the same way;
+ * they differ only in their value width, their output formats and the
+ * register index that suits their address space. This file holds that
+ * logic once and is included by ddrconfcmp.c for each type, after defining
+ *
+ *   ENGINE_TYPE              name suffix: compare_<type>_cfg_arrays(), ...
+ *   ENGINE_TABLE             working table type (struct ddrc_table, ...)
+ *   ENGINE_TABLE_ALLOC       allocator of that table type
+ *   ENGINE_TABLE_CRC         CRC of a table in its loaded layout
+ *   ENGINE_COMMON1/2         struct common_set members holding the common tables
+ *   ENGINE_INDEX             register index (reg_index or phy_index)
+ *   ENGINE_ENTRY_SIZE        size of one entry in the loaded layout
+ *   ENGINE_FMT_REG/VAL       register and value formats
+ *   ENGINE_FMT_ENTRY(_4)     entry formats, 3- and 4-digit positions
+ *   ENGINE_FMT_DIFF(_4)      value difference formats
+ *   ENGINE_FMT_UNIQUE_RIGHT  format of right-hand unique entries
+ *   ENGINE_COLUMN_WIDTH      side-by-side column width
+ *
+ * and providing print_reorder_block_<type>(), whose layout is per type.
+ * Temporary buffers come from the scratch arena and live until the end of
+ * the section being compared.
+ * All parameters are compile-time constants, so the generated functions
+ * carry no run-time type dispatch. The parameters are undefined again at
+ * the end of this file.
+ */
+
+#define ENGINE_CAT3_(a, b, c) a##b##c
+#define ENGINE_CAT3(a, b, c) ENGINE_CAT3_(a, b, c)
+#define ENGINE_FN(name) ENGINE_CAT3(name, _, ENGINE_TYPE)
+#define ENGINE_INDEX_FN(name) ENGINE_CAT3(ENGINE_INDEX, _, name)
+
+/**
+ * @brief Classify registers as common or unique in one indexed pass
+ *
+ * Each side is indexed once and the other side is looked up against it,
+ * giving the membership bitmaps, the common counts and the compacted common
+ * tables together, all in scratch memory.
+ *
+ * @return 0 on success, -1 if out of memory
+ */
+static int ENGINE_FN(classify_common)(const ENGINE_TABLE *cfg1, const ENGINE_TABLE *cfg2,
+                                      struct common_set *set) {
+	unsigned int num1 = cfg1->num, num2 = cfg2->num;
+	struct ENGINE_INDEX index1, index2;
+
+	memset(set, 0, sizeof(*set));
+	if (ENGINE_INDEX_FN(init)(&index1, cfg1->reg, num1) != 0 ||
+	    ENGINE_INDEX_FN(init)(&index2, cfg2->reg, num2) != 0) {
+		return -1;
+	}
+
+	set->member1 = scratch_calloc(BITMAP_WORDS(num1) + 1, sizeof(uint64_t));
+	set->member2 = scratch_calloc(BITMAP_WORDS(num2) + 1, sizeof(uint64_t));
+	if (!set->member1 || !set->member2 ||
+	    ENGINE_TABLE_ALLOC(&set->ENGINE_COMMON1, num1, scratch_alloc) != 0 ||
+	    ENGINE_TABLE_ALLOC(&set->ENGINE_COMMON2, num2, scratch_alloc) != 0) {
+		return -1;
+	}
+
+	for (unsigned int i = 0; i < num1; i++) {
+		if (ENGINE_INDEX_FN(contains)(&index2, cfg1->reg[i])) {
+			set_bit(set->member1, i);
+			set->ENGINE_COMMON1.reg[set->count1] = cfg1->reg[i];
+			set->ENGINE_COMMON1.val[set->count1++] = cfg1->val[i];
+		}
+	}
+	for (unsigned int i = 0; i < num2; i++) {
+		if (ENGINE_INDEX_FN(contains)(&index1, cfg2->reg[i])) {
+			set_bit(set->member2, i);
+			set->ENGINE_COMMON2.reg[set->count2] = cfg2->reg[i];
+			set->ENGINE_COMMON2.val[set->count2++] = cfg2->val[i];
+		}
+	}
+	set->ENGINE_COMMON1.num = set->count1;
+	set->ENGINE_COMMON2.num = set->count2;
+
+	return 0;
+}
+
+/**
+ * @brief Display the unique registers of a classification side-by-side
+ */
+static void ENGINE_FN(find_and_display_unique)(const ENGINE_TABLE *cfg1, const ENGINE_TABLE *cfg2,
+                                               const struct common_set *set, const char *indent) {
+	unsigned int num1 = cfg1->num, num2 = cfg2->num;
+	int left_count = num1 - set->count1;
+	int right_count = num2 - set->count2;
+	unsigned int left_pos = 0, right_pos = 0;
+
+	if (left_count == 0 && right_count == 0) {
+		return;
+	}
+
+	print_unique_header(indent, ENGINE_COLUMN_WIDTH);
+
+	int max_unique = (left_count > right_count) ? left_count : right_count;
+
+	for (int line = 0; line < max_unique; line++) {
+		char left_str[ENGINE_COLUMN_WIDTH + 1] = "";
+		char right_str[ENGINE_COLUMN_WIDTH + 1] = "";
+
+		/* Only the longer side is listed */
+		left_pos = next_unique(set->member1, num1, left_pos);
+		if (num1 > num2 && left_pos < num1) {
+			snprintf(left_str, sizeof(left_str), ENGINE_FMT_ENTRY, (int)left_pos, cfg1->reg[left_pos], cfg1->val[left_pos]);
+		}
+		left_pos++;
+
+		right_pos = next_unique(set->member2, num2, right_pos);
+		if (num2 > num1 && right_pos < num2) {
+			snprintf(right_str, sizeof(right_str), ENGINE_FMT_UNIQUE_RIGHT, (int)right_pos, cfg2->reg[right_pos], cfg2->val[right_pos]);
+		}
+		right_pos++;
+
+		print_side_by_side(left_str, right_str, indent, ENGINE_COLUMN_WIDTH);
+	}
+}
+
+/**
+ * @brief Print the entries between two runs kept in order
+ *
+ * Moved blocks touching the gap are reported first, then the remaining
+ * left-only and right-only stretches are shown side-by-side.
+ */
+static void ENGINE_FN(print_reorder_gap)(const ENGINE_TABLE *cfg1, unsigned int x0, unsigned int x1,
+                                         const ENGINE_TABLE *cfg2, unsigned int y0, unsigned int y1,
+                                         struct block_move *moves, const int *move1, const int *move2,
+                                         const char *indent) {
+	unsigned int p, q;
+
+	for (p = x0; p < x1; p++) {
+		if (move1[p] >= 0) print_block_move(&moves[move1[p]], indent);
+	}
+	for (q = y0; q < y1; q++) {
+		if (move2[q] >= 0) print_block_move(&moves[move2[q]], indent);
+	}
+
+	p = x0;
+	q = y0;
+	for (;;) {
+		unsigned int ls, rs;
+
+		while (p < x1 && move1[p] >= 0) p++;
+		for (ls = p; p < x1 && move1[p] < 0; p++);
+		while (q < y1 && move2[q] >= 0) q++;
+		for (rs = q; q < y1 && move2[q] < 0; q++);
+
+		if (p == ls && q == rs) {
+			break;
+		}
+		ENGINE_FN(print_reorder_block)(cfg1, ls, p - ls, cfg2, rs, q - rs, indent);
+	}
+}
+
+/**
+ * @brief Display the reordered registers from the diff's edit script
+ *
+ * @return 0 on success, -1 if out of memory
+ */
+static int ENGINE_FN(display_reorder)(const ENGINE_TABLE *cfg1, const ENGINE_TABLE *cfg2,
+                                      const char *indent) {
+	unsigned int num1 = cfg1->num, num2 = cfg2->num;
+	int *move1 = scratch_alloc((num1 + 1) * sizeof(*move1));
+	int *move2 = scratch_alloc((num2 + 1) * sizeof(*move2));
+	struct diff_run *runs = NULL;
+	struct block_move *moves = NULL;
+	unsigned int num_runs = 0, num_moves = 0;
+	unsigned int x = 0, y = 0;
+
+	if (move1 && move2) {
+		runs = diff_registers(cfg1->reg, num1, cfg2->reg, num2, &num_runs);
+	}
+	if (runs) {
+		moves = find_block_moves(cfg1->reg, num1, cfg2->reg, num2, runs, num_runs,
+		                         move1, move2, &num_moves);
+	}
+	if (!moves) {
+		print_error(indent, "Memory allocation failed for reorder display");
+		return -1;
+	}
+
+	/* Everything between two runs kept in order was moved */
+	for (unsigned int r = 0; r <= num_runs; r++) {
+		unsigned int run_x = (r < num_runs) ? runs[r].x : num1;
+		unsigned int run_y = (r < num_runs) ? runs[r].y : num2;
+
+		ENGINE_FN(print_reorder_gap)(cfg1, x, run_x, cfg2, y, run_y, moves, move1, move2, indent);
+		if (r == num_runs) {
+			break;
+		}
+
+#if SHOW_IDENTICAL_RANGES
+		/* Only show if more than a few registers to reduce noise */
+		if (runs[r].len > 10) {
+			fprintf(out, "%s  [%4d-%4d] (%d registers)           [%4d-%4d] (%d registers)\n",
+			       indent, run_x, run_x + runs[r].len - 1, runs[r].len,
+			       run_y, run_y + runs[r].len - 1, runs[r].len);
+		}
+#endif
+		x = run_x + runs[r].len;
+		y = run_y + runs[r].len;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Compare two tables as register sets, ignoring their order
+ *
+ * @return -1 if the register sets differ, 0 otherwise (diff_count_p gets
+ *         the number of value differences)
+ */
+static int ENGINE_FN(compare_unordered)(const ENGINE_TABLE *cfg1, const ENGINE_TABLE *cfg2,
+                                        const char *indent, int *diff_count_p) {
+	unsigned int num1 = cfg1->num, num2 = cfg2->num;
+	struct sorted_merge merge;
+	int diff_count = 0;
+	int ret;
+
+	memset(&merge, 0, sizeof(merge));
+	merge.sorted1 = scratch_alloc((num1 + 1) * sizeof(*merge.sorted1));
+	merge.sorted2 = scratch_alloc((num2 + 1) * sizeof(*merge.sorted2));
+	if (merge.sorted1 && merge.sorted2) {
+		for (unsigned int i = 0; i < num1; i++) {
+			merge.sorted1[i].reg = cfg1->reg[i];
+			merge.sorted1[i].pos = i;
+		}
+		for (unsigned int i = 0; i < num2; i++) {
+			merge.sorted2[i].reg = cfg2->reg[i];
+			merge.sorted2[i].pos = i;
+		}
+	}
+	if (!merge.sorted1 || !merge.sorted2 || sorted_merge_run(&merge, num1, num2) != 0) {
+		print_error(indent, "Memory allocation failed for order-insensitive comparison");
+		return -1;
+	}
+
+	if (merge.num_only1 || merge.num_only2) {
+		unsigned int lines = merge.num_only1 > merge.num_only2 ? merge.num_only1 : merge.num_only2;
+		unsigned int i = 0, j = 0;
+
+		print_warning(indent, "Structural differences found");
+		print_unique_header(indent, ENGINE_COLUMN_WIDTH);
+		for (unsigned int line = 0; line < lines; line++) {
+			char left_str[ENGINE_COLUMN_WIDTH + 1] = "";
+			char right_str[ENGINE_COLUMN_WIDTH + 1] = "";
+
+			while (i < num1 && merge.partner1[i] != MERGE_NONE) i++;
+			while (j < num2 && merge.partner2[j] != MERGE_NONE) j++;
+			if (i < num1) {
+				snprintf(left_str, sizeof(left_str), ENGINE_FMT_ENTRY, (int)i, cfg1->reg[i], cfg1->val[i]);
+				i++;
+			}
+			if (j < num2) {
+				snprintf(right_str, sizeof(right_str), ENGINE_FMT_ENTRY, (int)j, cfg2->reg[j], cfg2->val[j]);
+				j++;
+			}
+			print_side_by_side(left_str, right_str, indent, ENGINE_COLUMN_WIDTH);
+		}
+	}
+
+	for (unsigned int i = 0; i < num1; i++) {
+		unsigned int j = merge.partner1[i];
+		if (j != MERGE_NONE && cfg1->val[i] != cfg2->val[j]) {
+			diff_count++;
+		}
+	}
+	if (diff_count > 0) {
+		print_info(indent, "Value differences: %d (order ignored)", diff_count);
+		print_info(indent, "Register value differences:");
+		for (unsigned int i = 0; i < num1; i++) {
+			unsigned int j = merge.partner1[i];
+			if (j != MERGE_NONE && cfg1->val[i] != cfg2->val[j]) {
+				fprintf(out, "%s    " ENGINE_FMT_DIFF_4 "\n", indent, (int)i, cfg1->reg[i], cfg1->val[i], cfg2->val[j]);
+			}
+		}
+	}
+
+	ret = (merge.num_only1 || merge.num_only2) ? -1 : 0;
+
+	if (diff_count_p) *diff_count_p = diff_count;
+	return ret;
+}
+
+/**
+ * @brief Compare the register state two tables leave behind
+ *
+ * The tables are programmed in order, so a register written more than once
+ * ends up holding its last value. One pass per side records, at the first
+ * occurrence of every register, the position of its last write; the two
+ * resulting register maps are then diffed through the indexes. Order and
+ * overwritten writes do not matter, and entries are reported at the
+ * position of their last write.
+ *
+ * @return -1 if the register sets differ, 0 otherwise (diff_count_p gets
+ *         the number of differing final values)
+ */
+static int ENGINE_FN(compare_effective)(const ENGINE_TABLE *cfg1, const ENGINE_TABLE *cfg2,
+                                        const char *indent, int *diff_count_p) {
+	unsigned int num1 = cfg1->num, num2 = cfg2->num;
+	unsigned int *last1 = scratch_alloc((num1 + 1) * sizeof(*last1));
+	unsigned int *last2 = scratch_alloc((num2 + 1) * sizeof(*last2));
+	uint64_t *differs = scratch_calloc(BITMAP_WORDS(num1) + 1, sizeof(*differs));
+	unsigned int regs1 = 0, regs2 = 0, only1 = 0, only2 = 0;
+	struct ENGINE_INDEX index1, index2;
+	int diff_count = 0;
+
+	if (!last1 || !last2 || !differs ||
+	    ENGINE_INDEX_FN(init)(&index1, cfg1->reg, num1) != 0 ||
+	    ENGINE_INDEX_FN(init)(&index2, cfg2->reg, num2) != 0) {
+		print_error(indent, "Memory allocation failed for effective-state comparison");
+		return -1;
+	}
+
+	/* Reduce each side to its registers and their last writes */
+	for (unsigned int i = 0; i < num1; i++) {
+		unsigned int f = ENGINE_INDEX_FN(find)(&index1, cfg1->reg[i]);
+		last1[f] = i;
+		if (f == i) {
+			regs1++;
+			only1 += !ENGINE_INDEX_FN(contains)(&index2, cfg1->reg[i]);
+		}
+	}
+	for (unsigned int i = 0; i < num2; i++) {
+		unsigned int f = ENGINE_INDEX_FN(find)(&index2, cfg2->reg[i]);
+		last2[f] = i;
+		if (f == i) {
+			regs2++;
+			only2 += !ENGINE_INDEX_FN(contains)(&index1, cfg2->reg[i]);
+		}
+	}
+
+	print_info(indent, "Effective state: Left=%u registers (%u writes), Right=%u registers (%u writes)",
+	           regs1, num1, regs2, num2);
+
+	if (only1 || only2) {
+		unsigned int lines = only1 > only2 ? only1 : only2;
+		unsigned int i = 0, j = 0;
+
+		print_warning(indent, "Structural differences found");
+		print_unique_header(indent, ENGINE_COLUMN_WIDTH);
+		for (unsigned int line = 0; line < lines; line++) {
+			char left_str[ENGINE_COLUMN_WIDTH + 1] = "";
+			char right_str[ENGINE_COLUMN_WIDTH + 1] = "";
+
+			while (i < num1 && (ENGINE_INDEX_FN(find)(&index1, cfg1->reg[i]) != i ||
+			                    ENGINE_INDEX_FN(contains)(&index2, cfg1->reg[i]))) i++;
+			while (j < num2 && (ENGINE_INDEX_FN(find)(&index2, cfg2->reg[j]) != j ||
+			                    ENGINE_INDEX_FN(contains)(&index1, cfg2->reg[j]))) j++;
+			if (i < num1) {
+				snprintf(left_str, sizeof(left_str), ENGINE_FMT_ENTRY,
+				         (int)last1[i], cfg1->reg[i], cfg1->val[last1[i]]);
+				i++;
+			}
+			if (j < num2) {
+				snprintf(right_str, sizeof(right_str), ENGINE_FMT_ENTRY,
+				         (int)last2[j], cfg2->reg[j], cfg2->val[last2[j]]);
+				j++;
+			}
+			print_side_by_side(left_str, right_str, indent, ENGINE_COLUMN_WIDTH);
+		}
+	}
+
+	/* Flag the common registers whose final values differ, at their first occurrence */
+	for (unsigned int i = 0; i < num1; i++) {
+		if (ENGINE_INDEX_FN(find)(&index1, cfg1->reg[i]) == i && ENGINE_INDEX_FN(contains)(&index2, cfg1->reg[i])) {
+			unsigned int j = ENGINE_INDEX_FN(find)(&index2, cfg1->reg[i]);
+			if (cfg1->val[last1[i]] != cfg2->val[last2[j]]) {
+				set_bit(differs, i);
+				diff_count++;
+			}
+		}
+	}
+	if (diff_count > 0) {
+		print_info(indent, "Value differences: %d (effective state)", diff_count);
+		print_info(indent, "Register value differences:");
+		for (unsigned int i = next_set_bit(differs, num1, 0); i < num1; i = next_set_bit(differs, num1, i + 1)) {
+			unsigned int j = ENGINE_INDEX_FN(find)(&index2, cfg1->reg[i]);
+			fprintf(out, "%s    " ENGINE_FMT_DIFF_4 "\n", indent, (int)last1[i], cfg1->reg[i],
+			        cfg1->val[last1[i]], cfg2->val[last2[j]]);
+		}
+	}
+
+	if (diff_count_p) *diff_count_p = diff_count;
+	return (only1 || only2) ? -1 : 0;
+}
+
+/**
+ * @brief Find duplicate registers in a table
+ *
+ * Every entry is grouped under the first occurrence of its register through
+ * the register index, so the table is scanned twice regardless of how many
+ * registers repeat or how often. Groups with more than one entry become the
+ * result, each listing all its positions in the shared pool.
+ *
+ * @param cfg Table to check
+ * @param dups Output set, allocated from the scratch arena
+ * @return Number of duplicate register addresses found (0 if out of memory)
+ */
+static int ENGINE_FN(find_duplicates)(const ENGINE_TABLE *cfg, struct duplicate_set *dups) {
+	unsigned int num = cfg->num;
+	struct ENGINE_INDEX index;
+	unsigned int *first = scratch_alloc((num + 1) * sizeof(*first));
+	unsigned int *slot = scratch_calloc(num + 1, sizeof(*slot));    /* per first position */
+	unsigned int num_groups = 0, total = 0;
+
+	duplicate_set_reserve(dups, 0, 0);
+	if (!first || !slot || ENGINE_INDEX_FN(init)(&index, cfg->reg, num) != 0) {
+		return 0;
+	}
+
+	/* Count the occurrences of every register at its first position */
+	for (unsigned int i = 0; i < num; i++) {
+		first[i] = ENGINE_INDEX_FN(find)(&index, cfg->reg[i]);
+		slot[first[i]]++;
+	}
+
+	for (unsigned int i = 0; i < num; i++) {
+		if (slot[i] > 1) {
+			num_groups++;
+			total += slot[i];
+		}
+	}
+
+	if (num_groups) {
+		if (duplicate_set_reserve(dups, num_groups, total) != 0) {
+			return 0;
+		}
+
+		/* Lay the groups out in order of first occurrence; slot becomes the write offset */
+		total = 0;
+		for (unsigned int i = 0; i < num; i++) {
+			if (slot[i] > 1) {
+				struct duplicate_info *group = &dups->groups[dups->num_groups++];
+				group->reg = cfg->reg[i];
+				group->first = total;
+				group->count = slot[i];
+				slot[i] = total;
+				total += group->count;
+			} else {
+				slot[i] = REG_INDEX_NONE;
+			}
+		}
+
+		for (unsigned int i = 0; i < num; i++) {
+			if (slot[first[i]] != REG_INDEX_NONE) {
+				dups->pool[slot[first[i]]++] = i;
+			}
+		}
+	}
+
+	return (int)dups->num_groups;
+}
+
+/**
+ * @brief Print duplicate registers side-by-side
+ */
+static void ENGINE_CAT3(print_duplicates_, ENGINE_TYPE, _sidebyside)(const struct duplicate_set *left,
+                                                                     const struct duplicate_set *right,
+                                                                     const char *indent) {
+	const struct duplicate_info *left_dups = left->groups, *right_dups = right->groups;
+	int left_count = (int)left->num_groups, right_count = (int)right->num_groups;
+
+	if (left_count == 0 && right_count == 0) {
+		return;
+	}
+
+	print_info(indent, "Duplicate registers:");
+	fprintf(out, "%s  LEFT                                   RIGHT\n", indent);
+	fprintf(out, "%s  ─────────────────────────────────────  ─────────────────────────────────────\n", indent);
+
+	int max_count = left_count > right_count ? left_count : right_count;
+
+	for (int i = 0; i < max_count; i++) {
+		char left_buf[50] = "";
+		char right_buf[50] = "";
+
+		if (i < left_count) {
+			snprintf(left_buf, sizeof(left_buf), ENGINE_FMT_REG " (%u times)",
+			         left_dups[i].reg, left_dups[i].count);
+		}
+
+		if (i < right_count) {
+			snprintf(right_buf, sizeof(right_buf), ENGINE_FMT_REG " (%u times)",
+			         right_dups[i].reg, right_dups[i].count);
+		}
+
+		fprintf(out, "%s  %-37s  %-37s\n", indent, left_buf, right_buf);
+	}
+}
+
+/**
+ * @brief Print the values at one paired occurrence of a duplicate register
+ *
+ * @param p Left position, MERGE_NONE if unpaired
+ * @param q Right position, MERGE_NONE if unpaired
+ */
+static void ENGINE_FN(print_interference_pair)(const ENGINE_TABLE *cfg1, const ENGINE_TABLE *cfg2,
+                                               unsigned int p, unsigned int q, const char *indent) {
+	if (p == q) {
+		fprintf(out, "%s        [%u] Left=" ENGINE_FMT_VAL ", Right=" ENGINE_FMT_VAL "\n",
+		       indent, p, cfg1->val[p], cfg2->val[q]);
+	} else if (q == MERGE_NONE) {
+		fprintf(out, "%s        [%u] Left=" ENGINE_FMT_VAL "\n", indent, p, cfg1->val[p]);
+	} else if (p == MERGE_NONE) {
+		fprintf(out, "%s        [%u] Right=" ENGINE_FMT_VAL "\n", indent, q, cfg2->val[q]);
+	} else {
+		fprintf(out, "%s        [%u] Left=" ENGINE_FMT_VAL ", [%u] Right=" ENGINE_FMT_VAL "\n",
+		       indent, p, cfg1->val[p], q, cfg2->val[q]);
+	}
+}
+
+/**
+ * @brief Check if duplicates interfere with value differences and warn about them
+ *
+ * Entries are paired by position when both tables are equally long, and
+ * otherwise the common registers of both sides are paired in order, as in
+ * the comparison of the common registers. One pass over the pairs marks
+ * every register whose values differ at the first left position of that
+ * register, so each duplicate group is then checked with a single lookup.
+ * Each register is reported once, left duplicates first.
+ *
+ * @param cfg1 Left table
+ * @param cfg2 Right table
+ * @param left Left duplicate set
+ * @param right Right duplicate set
+ * @param indent Indentation for output
+ */
+static void ENGINE_FN(check_duplicate_interference)(const ENGINE_TABLE *cfg1, const ENGINE_TABLE *cfg2,
+                                                    const struct duplicate_set *left,
+                                                    const struct duplicate_set *right,
+                                                    const char *indent) {
+	unsigned int num1 = cfg1->num, num2 = cfg2->num;
+	unsigned int *partner1 = scratch_alloc((num1 + 1) * sizeof(*partner1));
+	unsigned int *partner2 = scratch_alloc((num2 + 1) * sizeof(*partner2));
+	uint64_t *involved = scratch_calloc(BITMAP_WORDS(num1) + 1, sizeof(*involved));
+	uint64_t *reported = scratch_calloc(BITMAP_WORDS(num1) + 1, sizeof(*reported));
+	struct ENGINE_INDEX index1, index2;
+	int interference_found = 0;
+
+	if (!partner1 || !partner2 || !involved || !reported ||
+	    ENGINE_INDEX_FN(init)(&index1, cfg1->reg, num1) != 0 ||
+	    ENGINE_INDEX_FN(init)(&index2, cfg2->reg, num2) != 0) {
+		print_error(indent, "Memory allocation failed for duplicate interference check");
+		return;
+	}
+
+	/* Pair the entries: by position, or common registers in order */
+	if (num1 == num2) {
+		for (unsigned int i = 0; i < num1; i++) {
+			partner1[i] = partner2[i] = i;
+		}
+	} else {
+		unsigned int j = 0;
+
+		for (unsigned int i = 0; i < num2; i++) {
+			partner2[i] = MERGE_NONE;
+		}
+		for (unsigned int i = 0; i < num1; i++) {
+			partner1[i] = MERGE_NONE;
+			if (!ENGINE_INDEX_FN(contains)(&index2, cfg1->reg[i])) {
+				continue;
+			}
+			while (j < num2 && !ENGINE_INDEX_FN(contains)(&index1, cfg2->reg[j])) {
+				j++;
+			}
+			if (j < num2) {
+				partner1[i] = j;
+				partner2[j++] = i;
+			}
+		}
+	}
+
+	/* Mark the registers of differing pairs */
+	for (unsigned int i = 0; i < num1; i++) {
+		unsigned int j = partner1[i];
+		if (j != MERGE_NONE && cfg1->val[i] != cfg2->val[j]) {
+			set_bit(involved, ENGINE_INDEX_FN(find)(&index1, cfg1->reg[i]));
+		}
+	}
+
+	/* Check both left and right duplicates, but report each register only once */
+	for (int side = 0; side < 2; side++) {
+		const struct duplicate_set *dups = (side == 0) ? left : right;
+
+		for (unsigned int d = 0; d < dups->num_groups; d++) {
+			const struct duplicate_info *group = &dups->groups[d];
+			const unsigned int *pos = dups->pool + group->first;
+			unsigned int dup_reg = group->reg;
+
+			if (!ENGINE_INDEX_FN(contains)(&index1, dup_reg)) {
+				continue;
+			}
+			unsigned int f = ENGINE_INDEX_FN(find)(&index1, dup_reg);
+			if (!test_bit(involved, f) || test_bit(reported, f)) {
+				continue;
+			}
+			set_bit(reported, f);
+
+			if (!interference_found) {
+				print_warning(indent, "Duplicate registers involved in value differences:");
+				interference_found = 1;
+			}
+
+			/* Print the duplicate register with all its instances */
+			fprintf(out, "%s    Reg " ENGINE_FMT_REG ": duplicated %u times at indices:", indent, dup_reg, group->count);
+			for (unsigned int idx = 0; idx < group->count; idx++) {
+				fprintf(out, " [%u]", pos[idx]);
+			}
+			fprintf(out, "\n");
+
+			/* Show the values at each duplicate location */
+			for (unsigned int idx = 0; idx < group->count; idx++) {
+				if (side == 0) {
+					ENGINE_FN(print_interference_pair)(cfg1, cfg2, pos[idx], partner1[pos[idx]], indent);
+				} else {
+					ENGINE_FN(print_interference_pair)(cfg1, cfg2, partner2[pos[idx]], pos[idx], indent);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * @brief Flag the value differences of two equally long tables in register order
+ *
+ * When both tables carry a CRC tree only the blocks whose CRCs differ are
+ * visited; every other block is taken to match in both columns.
+ * @param mask Output bitmap, BITMAP_WORDS(num) words, one word per block
+ * @return Number of differing values, -1 if the registers are not in the same order
+ */
+static int ENGINE_FN(diff_in_order)(const ENGINE_TABLE *cfg1, const ENGINE_TABLE *cfg2, uint64_t *mask) {
+	unsigned int num = cfg1->num;
+	unsigned int blocks = BITMAP_WORDS(num);
+	uint64_t *changed = NULL;
+	unsigned int b;
+	int count = 0;
+
+	memset(mask, 0, blocks * sizeof(*mask));
+	if (cfg1->tree.levels && cfg2->tree.levels) {
+		/* Without this bitmap every block is simply compared */
+		changed = scratch_calloc(BITMAP_WORDS(blocks) + 1, sizeof(*changed));
+		if (changed) {
+			crc_tree_diff(&cfg1->tree, &cfg2->tree, cfg1->tree.levels - 1, 0, changed);
+		}
+	}
+
+	for (b = changed ? next_set_bit(changed, blocks, 0) : 0; b < blocks;
+	     b = changed ? next_set_bit(changed, blocks, b + 1) : b + 1) {
+		unsigned int start = b * CRC_BLOCK;
+		unsigned int len = num - start < CRC_BLOCK ? num - start : CRC_BLOCK;
+
+		for (unsigned int i = start; i < start + len; i++) {
+			if (cfg1->reg[i] != cfg2->reg[i]) {
+				return -1;
+			}
+		}
+		count += diff_records(cfg1->val + start, cfg2->val + start, len, sizeof(*cfg1->val), &mask[b]);
+	}
+
+	return count;
+}
+
+/**
+ * @brief Compare two register tables
+ *
+ * @param cfg1 First table
+ * @param cfg2 Second table
+ * @param indent Indentation string for output
+ * @param diff_count_p Pointer to store the number of value differences (optional, can be NULL)
+ * @param print_header If non-zero, print entry count and size information
+ * @return int Result code: -1 (structural error), 0 (same order), 1 (different order)
+ */
+static int ENGINE_CAT3(compare_, ENGINE_TYPE, _cfg_arrays)(const ENGINE_TABLE *cfg1, const ENGINE_TABLE *cfg2,
+                                                           const char *indent, int *diff_count_p, int print_header) {
+	unsigned int num1 = cfg1->num, num2 = cfg2->num;
+	int i;
+	int diff_count = 0;
+	int same_order = 1;
+
+	if (print_header) {
+		uint32_t crc_left = ENGINE_TABLE_CRC(cfg1);
+		uint32_t crc_right = ENGINE_TABLE_CRC(cfg2);
+		fprintf(out, "%sEntries: Left=%u, Right=%u\n", indent, num1, num2);
+		fprintf(out, "%sSize:    Left=%u bytes (%.2f kB), Right=%u bytes (%.2f kB)\n",
+		       indent, num1 * ENGINE_ENTRY_SIZE, num1 * ENGINE_ENTRY_SIZE / 1024.0,
+		       num2 * ENGINE_ENTRY_SIZE, num2 * ENGINE_ENTRY_SIZE / 1024.0);
+		fprintf(out, "%sCRC:     Left=0x%08x, Right=0x%08x\n", indent, crc_left, crc_right);
+	}
+
+	if (opt_effective) {
+		return ENGINE_FN(compare_effective)(cfg1, cfg2, indent, diff_count_p);
+	}
+	if (opt_ignore_order) {
+		return ENGINE_FN(compare_unordered)(cfg1, cfg2, indent, diff_count_p);
+	}
+
+	if (num1 != num2) {
+		print_warning(indent, "Structural differences found");
+
+		/* Split into common and unique registers in one indexed pass */
+		struct common_set set;
+		if (ENGINE_FN(classify_common)(cfg1, cfg2, &set) != 0) {
+			print_error(indent, "Memory allocation failed for common register comparison");
+			return -1;
+		}
+
+		/* Display unique registers side-by-side */
+		ENGINE_FN(find_and_display_unique)(cfg1, cfg2, &set, indent);
+
+		/* Compare common registers */
+		fprintf(out, "\n");
+		fprintf(out, "%s┌─ Comparing common registers ──────────────────────────────┐\n", indent);
+
+		unsigned int common_count1 = set.count1, common_count2 = set.count2;
+		if (common_count1 != common_count2) {
+			print_error(indent, "Internal error: common register counts don't match (%u vs %u)", common_count1, common_count2);
+			fprintf(out, "%s└──────────────────────────────────────────────────────────┘\n", indent);
+			return -1;
+		}
+
+		if (common_count1 > 0) {
+			char nested_indent[32];
+			snprintf(nested_indent, sizeof(nested_indent), "%s  ", indent);
+
+			/* Recursively compare common registers */
+			int common_result = ENGINE_CAT3(compare_, ENGINE_TYPE, _cfg_arrays)(
+				&set.ENGINE_COMMON1, &set.ENGINE_COMMON2, nested_indent, diff_count_p, 1);
+
+			/* Print summary for common register comparison */
+			int common_diff_count = diff_count_p ? *diff_count_p : 0;
+			print_comparison_summary(common_result, common_diff_count, nested_indent);
+			fprintf(out, "%s└──────────────────────────────────────────────────────────┘\n", indent);
+		} else {
+			print_info(indent, "No common registers found");
+		}
+
+		return -1; /* Length mismatch is structural error */
+	}
+
+	/* Same length - check the order and flag the value differences block by block */
+	uint64_t *diff_mask = scratch_alloc((BITMAP_WORDS(num1) + 1) * sizeof(*diff_mask));
+	if (!diff_mask) {
+		print_error(indent, "Memory allocation failed for value comparison");
+		return -1;
+	}
+	diff_count = ENGINE_FN(diff_in_order)(cfg1, cfg2, diff_mask);
+	same_order = diff_count >= 0;
+
+	if (same_order) {
+		/* Print summary before details */
+		if (diff_count > 0) {
+			print_info(indent, "Registers match, %d value differences", diff_count);
+			print_info(indent, "Register value differences:");
+		}
+
+		/* Now print the details, visiting only the flagged entries */
+		for (i = next_set_bit(diff_mask, num1, 0); i < (int)num1; i = next_set_bit(diff_mask, num1, i + 1)) {
+			fprintf(out, "%s    " ENGINE_FMT_DIFF "\n",
+			       indent, i, cfg1->reg[i], cfg1->val[i], cfg2->val[i]);
+		}
+
+		/* Return: 0 if all match, 1 if value differences */
+		if (diff_count_p) *diff_count_p = diff_count;
+		return 0;
+	} else {
+		/* Different order - check if all registers exist in both arrays */
+		int all_present = 1;
+		struct ENGINE_INDEX index1, index2;
+
+		diff_count = 0;
+
+		if (ENGINE_INDEX_FN(init)(&index1, cfg1->reg, num1) != 0 ||
+		    ENGINE_INDEX_FN(init)(&index2, cfg2->reg, num2) != 0) {
+			print_error(indent, "Memory allocation failed for register index");
+			return -1;
+		}
+
+		/* Check if all registers from left exist in right */
+		for (i = 0; i < (int)num1; i++) {
+			if (!ENGINE_INDEX_FN(contains)(&index2, cfg1->reg[i])) {
+				if (all_present) {
+					print_error(indent, "Arrays have same length but different register sets!");
+					print_info(indent, "Registers in LEFT but not in RIGHT:");
+					all_present = 0;
+				}
+				fprintf(out, "%s    " ENGINE_FMT_ENTRY "\n", indent, i, cfg1->reg[i], cfg1->val[i]);
+			}
+		}
+
+		/* Check if all registers from right exist in left */
+		for (i = 0; i < (int)num2; i++) {
+			if (!ENGINE_INDEX_FN(contains)(&index1, cfg2->reg[i])) {
+				if (all_present) {
+					print_error(indent, "Arrays have same length but different register sets!");
+					all_present = 0;
+				}
+				if (!all_present && i == 0) {
+					print_info(indent, "Registers in RIGHT but not in LEFT:");
+				}
+				fprintf(out, "%s    " ENGINE_FMT_ENTRY "\n", indent, i, cfg2->reg[i], cfg2->val[i]);
+			}
+		}
+
+		if (!all_present) {
+			/* Different register sets - structural error */
+			return -1;
+		}
+
+		/* All registers present but different order - print warning first, then show the moved blocks */
+		print_warning(indent, "Registers match, different order");
+		print_reorder_header(indent);
+
+		if (ENGINE_FN(display_reorder)(cfg1, cfg2, indent) != 0) {
+			return -1;
+		}
+
+		/* Count value differences first, against the first occurrence in cfg2 */
+		for (i = 0; i < (int)num1; i++) {
+			unsigned int j = ENGINE_INDEX_FN(find)(&index2, cfg1->reg[i]);
+			if (cfg1->val[i] != cfg2->val[j]) {
+				diff_count++;
+			}
+		}
+
+		/* Print summary and details for value differences */
+		if (diff_count > 0) {
+			print_info(indent, "Value differences: %d", diff_count);
+			print_info(indent, "Register value differences:");
+			/* Now print the details */
+			for (i = 0; i < (int)num1; i++) {
+				unsigned int j = ENGINE_INDEX_FN(find)(&index2, cfg1->reg[i]);
+				if (cfg1->val[i] != cfg2->val[j]) {
+					fprintf(out, "%s    " ENGINE_FMT_DIFF_4 "\n",
+					       indent, i, cfg1->reg[i], cfg1->val[i], cfg2->val[j]);
+				}
+			}
+		}
+
+		/* Return: 2 for different order (diff_count tracks value differences) */
+		if (diff_count_p) *diff_count_p = diff_count;
+
+		return 1;
+	}
+}
+
+#undef ENGINE_CAT3_
+#undef ENGINE_CAT3
+#undef ENGINE_FN
+#undef ENGINE_INDEX_FN
+
+#undef ENGINE_TYPE
+#undef ENGINE_TABLE
+#undef ENGINE_TABLE_ALLOC
+#undef ENGINE_TABLE_CRC
+#undef ENGINE_COMMON1
+#undef ENGINE_COMMON2
+#undef ENGINE_INDEX
+#undef ENGINE_ENTRY_SIZE
+#undef ENGINE_FMT_REG
+#undef ENGINE_FMT_VAL
+#undef ENGINE_FMT_ENTRY
+#undef ENGINE_FMT_ENTRY_4
+#undef ENGINE_FMT_DIFF
+#undef ENGINE_FMT_DIFF_4
+#undef ENGINE_FMT_UNIQUE_RIGHT
+#undef ENGINE_COLUMN_WIDTH
@@ -7,10 +7,15 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <libgen.h>
+#include <pthread.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 
-#include "confcmp.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "ddrconf.h"
 
 /**
  * @file ddrconfcmp.c
@@ -20,6 +25,10 @@
  * for the DART-MX95 platform. It performs deep structural and value comparison
  * of register configurations.
  * 
+ * Both configurations are loaded at runtime from the DDR Tool generated
+ * lpddr5_timing.c sources given on the command line (see ddrconf.h), so a
+ * single build of the tool compares any pair of configurations.
+ * 
  * COMPARISON APPROACH:
  * ====================
  * 
@@ -94,10 +103,15 @@
  *      * When enabled: Full duplicate detection with optimized grouped output
  * 
  * 7. MEMORY MANAGEMENT:
- *    - Dynamic allocation for temporary common register arrays
- *    - Proper malloc/free pairing for all allocations
- *    - Error handling for allocation failures
- *    - calloc used for zero-initialized processed flags in duplicate detection
+ *    - Loaded tables are allocated once with malloc and freed at exit
+ *    - Everything a section needs while comparing (common register arrays,
+ *      register indexes, difference bitmaps, duplicate sets) comes from one
+ *      scratch arena via scratch_alloc(), with no per-buffer free
+ *    - scratch_reset() releases the whole arena after each section and
+ *      sizes it to the largest section seen, so later sections reuse it
+ *    - Allocation failures are reported and end the current comparison
+ *    - --stats reports the arena's allocations, sections, system
+ *      allocations and largest section
  * 
  * EXAMPLE COMPARISON FLOW:
  * ========================
@@ -133,6 +147,24 @@
 /* Global flag for --list-duplicates option */
 static int opt_list_duplicates = 0;
 
+/* Global flag for --ignore-order option */
+static int opt_ignore_order = 0;
+
+/* Global flag for --effective option */
+static int opt_effective = 0;
+
+/* Global flag for --stats option */
+static int opt_stats = 0;
+
+/* Configurations under comparison, loaded from the command line */
+static struct ddrconf conf_left;
+static struct ddrconf conf_right;
+static struct dram_timing_info dram_timing_left;
+static struct dram_timing_info dram_timing_right;
+
+/* Report stream: stdout, or the buffer of the section being compared */
+static FILE *out;
+
 #if DEBUG
 #define DEBUG_PRINT(...) do{ fprintf( stderr, __VA_ARGS__ ); } while( 0 )
 #else
@@ -165,15 +197,15 @@ static int opt_list_duplicates = 0;
 
 /**
  * @brief Calculate CRC32 checksum
+ * @param crc  CRC of the preceding data, 0 to start a new checksum
  * @param addr Pointer to data buffer
  * @param size Size of data in bytes
  * @return CRC32 checksum
  */
-static uint32_t compute_crc32(const uint8_t *addr, uint32_t size)
+static uint32_t compute_crc32(uint32_t crc, const uint8_t *addr, uint32_t size)
 {
     const uint8_t *a = addr;
     uint32_t sz = size;
-    uint32_t crc = 0U;
 
     /* Poly table */
     static uint32_t const s_crcTable[] =
@@ -204,11 +236,11 @@ static uint32_t compute_crc32(const uint8_t *addr, uint32_t size)
  */
 static void print_error(const char *indent, const char *format, ...) {
 	va_list args;
-	printf("%s" COLOR_RED "E: ", indent);
+	fprintf(out, "%s" COLOR_RED "E: ", indent);
 	va_start(args, format);
-	vprintf(format, args);
+	vfprintf(out, format, args);
 	va_end(args);
-	printf(COLOR_RESET "\n");
+	fprintf(out, COLOR_RESET "\n");
 }
 
 /**
@@ -216,11 +248,11 @@ static void print_error(const char *indent, const char *format, ...) {
  */
 static void print_warning(const char *indent, const char *format, ...) {
 	va_list args;
-	printf("%s" COLOR_YELLOW "W: ", indent);
+	fprintf(out, "%s" COLOR_YELLOW "W: ", indent);
 	va_start(args, format);
-	vprintf(format, args);
+	vfprintf(out, format, args);
 	va_end(args);
-	printf(COLOR_RESET "\n");
+	fprintf(out, COLOR_RESET "\n");
 }
 
 /**
@@ -228,11 +260,11 @@ static void print_warning(const char *indent, const char *format, ...) {
  */
 static void print_info(const char *indent, const char *format, ...) {
 	va_list args;
-	printf("%s" COLOR_YELLOW "I: ", indent);
+	fprintf(out, "%s" COLOR_YELLOW "I: ", indent);
 	va_start(args, format);
-	vprintf(format, args);
+	vfprintf(out, format, args);
 	va_end(args);
-	printf(COLOR_RESET "\n");
+	fprintf(out, COLOR_RESET "\n");
 }
 
 /**
@@ -240,11 +272,11 @@ static void print_info(const char *indent, const char *format, ...) {
  */
 static void print_success(const char *indent, const char *format, ...) {
 	va_list args;
-	printf("%s" COLOR_GREEN, indent);
+	fprintf(out, "%s" COLOR_GREEN, indent);
 	va_start(args, format);
-	vprintf(format, args);
+	vfprintf(out, format, args);
 	va_end(args);
-	printf(COLOR_RESET "\n");
+	fprintf(out, COLOR_RESET "\n");
 }
 
 /**
@@ -257,7 +289,7 @@ static void print_success(const char *indent, const char *format, ...) {
  */
 static void print_side_by_side(const char *left, const char *right, 
                                const char *indent, int column_width) {
-	printf("%s  %-*s  %s\n", indent, column_width, left, right);
+	fprintf(out, "%s  %-*s  %s\n", indent, column_width, left, right);
 }
 
 /**
@@ -268,19 +300,19 @@ static void print_side_by_side(const char *left, const char *right,
  */
 static void print_unique_header(const char *indent, int column_width) {
 	print_info(indent, "Unique registers:");
-	printf("%s  %-*s  %s\n", indent, column_width, "LEFT", "RIGHT");
+	fprintf(out, "%s  %-*s  %s\n", indent, column_width, "LEFT", "RIGHT");
 	
 	/* Print separator line matching column width */
 	const char *sep_char = "─";
-	printf("%s  ", indent);
+	fprintf(out, "%s  ", indent);
 	for (int i = 0; i < column_width; i++) {
-		printf("%s", sep_char);
+		fprintf(out, "%s", sep_char);
 	}
-	printf("  ");
+	fprintf(out, "  ");
 	for (int i = 0; i < column_width; i++) {
-		printf("%s", sep_char);
+		fprintf(out, "%s", sep_char);
 	}
-	printf("\n");
+	fprintf(out, "\n");
 }
 
 /**
@@ -290,1349 +322,1478 @@ static void print_unique_header(const char *indent, int column_width) {
  */
 static void print_reorder_header(const char *indent) {
 	print_info(indent, "Reordered registers:");
-	printf("%s  LEFT                                 RIGHT\n", indent);
-	printf("%s  ───────────────────────────────────  ───────────────────────────────────\n", indent);
+	fprintf(out, "%s  LEFT                                 RIGHT\n", indent);
+	fprintf(out, "%s  ───────────────────────────────────  ───────────────────────────────────\n", indent);
 }
 
 /* ============================================================================
- * DDRC-specific helper functions
- * ============================================================================ */
+ * Scratch arena
+ * ============================================================================
+ *
+ * The temporary buffers of a section comparison (common register tables,
+ * register indexes, bitmaps and the diff, move, sort and duplicate work
+ * arrays) are carved from one bump arena and released together when the
+ * section is done, instead of being freed one by one. Requests that do not
+ * fit are served from extra blocks; the reset then grows the arena to what
+ * the section needed, so from then on a comparison makes no allocator
+ * calls. Only the compare stage uses it.
+ */
+
+#define SCRATCH_ALIGN 16
+#define SCRATCH_MIN_BLOCK (64 * 1024)
+
+/* Extra block, its data starting SCRATCH_ALIGN bytes in */
+struct scratch_block {
+	struct scratch_block *next;
+};
+
+struct scratch_arena {
+	unsigned char *base;            /* main block, kept across resets */
+	size_t size;
+	unsigned char *cur;             /* free space being carved */
+	size_t left;
+	struct scratch_block *extra;    /* blocks taken since the last reset */
+	size_t wanted;                  /* bytes requested since the last reset */
+	size_t peak;                    /* most bytes wanted by one section */
+	unsigned long allocs;           /* requests served */
+	unsigned long system_allocs;    /* blocks obtained from malloc */
+	unsigned int resets;
+};
+
+static struct scratch_arena scratch;
 
 /**
- * @brief Find unique registers and display them side-by-side for DDRC
+ * @brief Allocate size bytes, valid until the next scratch_reset()
+ *
+ * @return NULL if out of memory
  */
-static void find_and_display_unique_ddrc(const struct ddrc_cfg_param *cfg1, unsigned int num1,
-                                          const struct ddrc_cfg_param *cfg2, unsigned int num2,
-                                          const char *indent) {
-	int left_count = 0, right_count = 0;
-	
-	/* Count unique registers */
-	for (int i = 0; i < (int)num1; i++) {
-		int found = 0;
-		for (int j = 0; j < (int)num2; j++) {
-			if (cfg1[i].reg == cfg2[j].reg) {
-				found = 1;
-				break;
-			}
-		}
-		if (!found) left_count++;
-	}
-	
-	for (int i = 0; i < (int)num2; i++) {
-		int found = 0;
-		for (int j = 0; j < (int)num1; j++) {
-			if (cfg2[i].reg == cfg1[j].reg) {
-				found = 1;
-				break;
-			}
-		}
-		if (!found) right_count++;
-	}
-	
-	if (left_count == 0 && right_count == 0) {
-		return;
+static void *scratch_alloc(size_t size) {
+	size_t block_size;
+	struct scratch_block *block;
+	void *p;
+
+	size = size ? (size + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1) : SCRATCH_ALIGN;
+	scratch.allocs++;
+	scratch.wanted += size;
+
+	if (size > scratch.left) {
+		/* Grow geometrically until the reset sizes the main block */
+		block_size = scratch.wanted > SCRATCH_MIN_BLOCK ? scratch.wanted : SCRATCH_MIN_BLOCK;
+		block = malloc(SCRATCH_ALIGN + block_size);
+		if (!block) {
+			return NULL;
+		}
+		scratch.system_allocs++;
+		block->next = scratch.extra;
+		scratch.extra = block;
+		scratch.cur = (unsigned char *)block + SCRATCH_ALIGN;
+		scratch.left = block_size;
 	}
-	
-	print_unique_header(indent, DDRC_COLUMN_WIDTH);
-	
-	int max_unique = (left_count > right_count) ? left_count : right_count;
-	
-	for (int line = 0; line < max_unique; line++) {
-		char left_str[DDRC_COLUMN_WIDTH + 1] = "";
-		char right_str[DDRC_COLUMN_WIDTH + 1] = "";
-		
-		/* Find next unique in left */
-		if (num1 > num2) {
-			int found_count = 0;
-			for (int i = 0; i < (int)num1; i++) {
-				int found = 0;
-				for (int j = 0; j < (int)num2; j++) {
-					if (cfg1[i].reg == cfg2[j].reg) {
-						found = 1;
-						break;
-					}
-				}
-				if (!found) {
-					if (found_count == line) {
-						snprintf(left_str, sizeof(left_str), FMT_DDRC_ENTRY, i, cfg1[i].reg, cfg1[i].val);
-						break;
-					}
-					found_count++;
-				}
-			}
-		}
-		
-		/* Find next unique in right */
-		if (num2 > num1) {
-			int found_count = 0;
-			for (int i = 0; i < (int)num2; i++) {
-				int found = 0;
-				for (int j = 0; j < (int)num1; j++) {
-					if (cfg2[i].reg == cfg1[j].reg) {
-						found = 1;
-						break;
-					}
-				}
-				if (!found) {
-					if (found_count == line) {
-						snprintf(right_str, sizeof(right_str), FMT_PHY_ENTRY, i, cfg2[i].reg, cfg2[i].val);
-						break;
-					}
-					found_count++;
-				}
-			}
-		}
-		
-		print_side_by_side(left_str, right_str, indent, DDRC_COLUMN_WIDTH);
+
+	p = scratch.cur;
+	scratch.cur += size;
+	scratch.left -= size;
+	return p;
+}
+
+static void *scratch_calloc(size_t num, size_t size) {
+	void *p = scratch_alloc(num * size);
+
+	if (p) {
+		memset(p, 0, num * size);
 	}
+	return p;
 }
 
 /**
- * @brief Count common registers for DDRC
+ * @brief Release everything allocated since the last reset
+ *
+ * The main block is regrown first if the extra blocks were needed.
  */
-static int count_common_ddrc(const struct ddrc_cfg_param *cfg1, unsigned int num1,
-                              const struct ddrc_cfg_param *cfg2, unsigned int num2,
-                              unsigned int *common1, unsigned int *common2) {
-	*common1 = 0;
-	*common2 = 0;
-	
-	for (int i = 0; i < (int)num1; i++) {
-		for (int j = 0; j < (int)num2; j++) {
-			if (cfg1[i].reg == cfg2[j].reg) {
-				(*common1)++;
-				break;
-			}
-		}
+static void scratch_reset(void) {
+	while (scratch.extra) {
+		struct scratch_block *next = scratch.extra->next;
+		free(scratch.extra);
+		scratch.extra = next;
 	}
-	
-	for (int i = 0; i < (int)num2; i++) {
-		for (int j = 0; j < (int)num1; j++) {
-			if (cfg2[i].reg == cfg1[j].reg) {
-				(*common2)++;
-				break;
-			}
+
+	if (scratch.wanted > scratch.size) {
+		free(scratch.base);
+		scratch.base = malloc(scratch.wanted);
+		scratch.size = scratch.base ? scratch.wanted : 0;
+		if (scratch.base) {
+			scratch.system_allocs++;
 		}
 	}
-	
-	return (*common1 == *common2) ? 0 : -1;
+	if (scratch.wanted > scratch.peak) {
+		scratch.peak = scratch.wanted;
+	}
+
+	scratch.cur = scratch.base;
+	scratch.left = scratch.size;
+	scratch.wanted = 0;
+	scratch.resets++;
 }
 
+static void scratch_free(void) {
+	while (scratch.extra) {
+		struct scratch_block *next = scratch.extra->next;
+		free(scratch.extra);
+		scratch.extra = next;
+	}
+	free(scratch.base);
+	scratch.base = scratch.cur = NULL;
+	scratch.size = scratch.left = 0;
+}
+
+/* ============================================================================
+ * Working tables
+ * ============================================================================
+ *
+ * The loaded tables are converted once, right after loading, into one
+ * column per field, and all comparison, duplicate and index code scans
+ * these columns. Register lookups then touch only the reg column and
+ * value checks only the val column, instead of striding over interleaved
+ * entries (6 bytes apart for the packed PHY layout). The packed layout is
+ * only reconstructed for the reported CRCs.
+ */
+
+/*
+ * Block CRC tree of a table: one CRC per CRC_BLOCK entries, in the layout
+ * of the reported table CRC, and above those one CRC per CRC_BLOCK child
+ * CRCs up to a single root. Two equally long tables are compared from the
+ * root down, descending only into the nodes whose CRCs differ, so blocks
+ * that are the same on both sides are never scanned entry by entry.
+ */
+#define CRC_BLOCK 64                /* entries per leaf and children per node, one bitmap word */
+#define CRC_TREE_MAX_LEVELS 6       /* 64^6 nodes exceed any 32-bit entry count */
+
+struct crc_tree {
+	uint32_t *node;                             /* all levels, leaves first */
+	unsigned int start[CRC_TREE_MAX_LEVELS];    /* first node of each level */
+	unsigned int count[CRC_TREE_MAX_LEVELS];    /* nodes on each level */
+	unsigned int levels;                        /* 0 if not built */
+};
+
+/* DDRC table: 32-bit registers and values */
+struct ddrc_table {
+	uint32_t *reg;
+	uint32_t *val;
+	unsigned int num;
+	struct crc_tree tree;       /* built for loaded tables only */
+};
+
+/* DDRPHY table: 20-bit registers, 16-bit values */
+struct phy_table {
+	uint32_t *reg;
+	uint16_t *val;
+	unsigned int num;
+	struct crc_tree tree;       /* built for loaded tables only */
+};
+
+/* All compared tables of one configuration, as in struct dram_timing_info */
+struct timing_tables {
+	struct ddrc_table ddrc_cfg;
+	struct ddrc_table *fsp_ddrc_cfg;        /* one per fsp_cfg entry */
+	struct phy_table ddrphy_cfg;
+	struct phy_table *fsp_phy_cfg;          /* one per fsp_msg entry */
+	struct phy_table *fsp_phy_msgh_cfg;
+	struct phy_table *fsp_phy_pie_cfg;
+	struct phy_table trained_csr;
+	struct phy_table pie;
+	unsigned int fsp_cfg_num;
+	unsigned int fsp_msg_num;
+};
+
+static struct timing_tables tables_left;
+static struct timing_tables tables_right;
+
 /**
- * @brief Extract common registers into new arrays for DDRC
+ * @brief Build the block CRC tree of a register and a value column
+ *
+ * @param val_size Size of one value, hashed right after its register
+ * @return 0 on success, -1 if out of memory
  */
-static void extract_common_ddrc(const struct ddrc_cfg_param *cfg1, unsigned int num1,
-                                 const struct ddrc_cfg_param *cfg2, unsigned int num2,
-                                 struct ddrc_cfg_param *common1, struct ddrc_cfg_param *common2) {
-	unsigned int idx1 = 0, idx2 = 0;
-	
-	for (int i = 0; i < (int)num1; i++) {
-		for (int j = 0; j < (int)num2; j++) {
-			if (cfg1[i].reg == cfg2[j].reg) {
-				common1[idx1++] = cfg1[i];
-				break;
-			}
+static int crc_tree_build(struct crc_tree *tree, const uint32_t *reg, const void *val, size_t val_size,
+                          unsigned int num) {
+	const uint8_t *v = val;
+	unsigned int total = 0;
+	unsigned int n = num;
+
+	memset(tree, 0, sizeof(*tree));
+	if (!num) {
+		return 0;
+	}
+
+	do {
+		n = (n + CRC_BLOCK - 1) / CRC_BLOCK;
+		tree->start[tree->levels] = total;
+		tree->count[tree->levels] = n;
+		total += n;
+		tree->levels++;
+	} while (n > 1);
+
+	tree->node = malloc(total * sizeof(*tree->node));
+	if (!tree->node) {
+		tree->levels = 0;
+		return -1;
+	}
+
+	/* Leaves: entries in the same byte order as the table CRC */
+	for (unsigned int b = 0; b < tree->count[0]; b++) {
+		unsigned int end = (b + 1) * CRC_BLOCK < num ? (b + 1) * CRC_BLOCK : num;
+		uint32_t crc = 0;
+
+		for (unsigned int i = b * CRC_BLOCK; i < end; i++) {
+			crc = compute_crc32(crc, (const uint8_t *)&reg[i], sizeof(reg[i]));
+			crc = compute_crc32(crc, v + i * val_size, val_size);
 		}
+		tree->node[b] = crc;
 	}
-	
-	for (int i = 0; i < (int)num2; i++) {
-		for (int j = 0; j < (int)num1; j++) {
-			if (cfg2[i].reg == cfg1[j].reg) {
-				common2[idx2++] = cfg2[i];
-				break;
-			}
+
+	/* Inner nodes: CRC over the CRCs of their children */
+	for (unsigned int l = 1; l < tree->levels; l++) {
+		const uint32_t *child = tree->node + tree->start[l - 1];
+
+		for (unsigned int k = 0; k < tree->count[l]; k++) {
+			unsigned int first = k * CRC_BLOCK;
+			unsigned int children = tree->count[l - 1] - first < CRC_BLOCK ?
+			                        tree->count[l - 1] - first : CRC_BLOCK;
+
+			tree->node[tree->start[l] + k] = compute_crc32(0, (const uint8_t *)&child[first],
+			                                               children * sizeof(*child));
 		}
 	}
+
+	return 0;
 }
 
-/* ============================================================================
- * DDRPHY-specific helper functions
- * ============================================================================ */
+static void crc_tree_free(struct crc_tree *tree) {
+	free(tree->node);
+	memset(tree, 0, sizeof(*tree));
+}
 
 /**
- * @brief Find unique registers and display them side-by-side for DDRPHY
+ * @brief Allocate both columns of a DDRC table in one block
+ *
+ * @param alloc malloc for loaded tables, scratch_alloc for temporary ones
+ * @return 0 on success, -1 if out of memory
  */
-static void find_and_display_unique_ddrphy(const struct ddrphy_cfg_param *cfg1, unsigned int num1,
-                                            const struct ddrphy_cfg_param *cfg2, unsigned int num2,
-                                            const char *indent) {
-	int left_count = 0, right_count = 0;
-	
-	/* Count unique registers */
-	for (int i = 0; i < (int)num1; i++) {
-		int found = 0;
-		for (int j = 0; j < (int)num2; j++) {
-			if (cfg1[i].reg == cfg2[j].reg) {
-				found = 1;
-				break;
-			}
-		}
-		if (!found) left_count++;
+static int ddrc_table_alloc(struct ddrc_table *t, unsigned int num, void *(*alloc)(size_t)) {
+	t->reg = alloc((num + 1) * (sizeof(*t->reg) + sizeof(*t->val)));
+	t->val = t->reg ? t->reg + num + 1 : NULL;
+	t->num = num;
+	memset(&t->tree, 0, sizeof(t->tree));
+	return t->reg ? 0 : -1;
+}
+
+/**
+ * @brief Allocate both columns of a DDRPHY table in one block
+ *
+ * @param alloc malloc for loaded tables, scratch_alloc for temporary ones
+ * @return 0 on success, -1 if out of memory
+ */
+static int phy_table_alloc(struct phy_table *t, unsigned int num, void *(*alloc)(size_t)) {
+	t->reg = alloc((num + 1) * (sizeof(*t->reg) + sizeof(*t->val)));
+	t->val = t->reg ? (uint16_t *)(t->reg + num + 1) : NULL;
+	t->num = num;
+	memset(&t->tree, 0, sizeof(t->tree));
+	return t->reg ? 0 : -1;
+}
+
+static void ddrc_table_free(struct ddrc_table *t) {
+	free(t->reg);
+	crc_tree_free(&t->tree);
+	memset(t, 0, sizeof(*t));
+}
+
+static void phy_table_free(struct phy_table *t) {
+	free(t->reg);
+	crc_tree_free(&t->tree);
+	memset(t, 0, sizeof(*t));
+}
+
+static int ddrc_table_load(struct ddrc_table *t, const struct ddrc_cfg_param *cfg, unsigned int num) {
+	if (ddrc_table_alloc(t, num, malloc) != 0) {
+		return -1;
 	}
-	
-	for (int i = 0; i < (int)num2; i++) {
-		int found = 0;
-		for (int j = 0; j < (int)num1; j++) {
-			if (cfg2[i].reg == cfg1[j].reg) {
-				found = 1;
-				break;
-			}
-		}
-		if (!found) right_count++;
+	for (unsigned int i = 0; i < num; i++) {
+		t->reg[i] = cfg[i].reg;
+		t->val[i] = cfg[i].val;
 	}
-	
-	if (left_count == 0 && right_count == 0) {
-		return;
+	return crc_tree_build(&t->tree, t->reg, t->val, sizeof(*t->val), num);
+}
+
+static int phy_table_load(struct phy_table *t, const struct ddrphy_cfg_param *cfg, unsigned int num) {
+	if (phy_table_alloc(t, num, malloc) != 0) {
+		return -1;
 	}
-	
-	print_unique_header(indent, PHY_COLUMN_WIDTH);
-	
-	int max_unique = (left_count > right_count) ? left_count : right_count;
-	
-	for (int line = 0; line < max_unique; line++) {
-		char left_str[PHY_COLUMN_WIDTH + 1] = "";
-		char right_str[PHY_COLUMN_WIDTH + 1] = "";
-		
-		/* Find next unique in left */
-		if (num1 > num2) {
-			int found_count = 0;
-			for (int i = 0; i < (int)num1; i++) {
-				int found = 0;
-				for (int j = 0; j < (int)num2; j++) {
-					if (cfg1[i].reg == cfg2[j].reg) {
-						found = 1;
-						break;
-					}
-				}
-				if (!found) {
-					if (found_count == line) {
-						snprintf(left_str, sizeof(left_str), FMT_PHY_ENTRY, i, cfg1[i].reg, cfg1[i].val);
-						break;
-					}
-					found_count++;
-				}
-			}
-		}
-		
-		/* Find next unique in right */
-		if (num2 > num1) {
-			int found_count = 0;
-			for (int i = 0; i < (int)num2; i++) {
-				int found = 0;
-				for (int j = 0; j < (int)num1; j++) {
-					if (cfg2[i].reg == cfg1[j].reg) {
-						found = 1;
-						break;
-					}
-				}
-				if (!found) {
-					if (found_count == line) {
-						snprintf(right_str, sizeof(right_str), FMT_PHY_ENTRY, i, cfg2[i].reg, cfg2[i].val);
-						break;
-					}
-					found_count++;
-				}
-			}
-		}
-		
-		print_side_by_side(left_str, right_str, indent, PHY_COLUMN_WIDTH);
+	for (unsigned int i = 0; i < num; i++) {
+		t->reg[i] = cfg[i].reg;
+		t->val[i] = cfg[i].val;
 	}
+	return crc_tree_build(&t->tree, t->reg, t->val, sizeof(*t->val), num);
 }
 
 /**
- * @brief Count common registers for DDRPHY
+ * @brief CRC32 of a DDRC table in its struct ddrc_cfg_param layout
  */
-static int count_common_ddrphy(const struct ddrphy_cfg_param *cfg1, unsigned int num1,
-                                const struct ddrphy_cfg_param *cfg2, unsigned int num2,
-                                unsigned int *common1, unsigned int *common2) {
-	*common1 = 0;
-	*common2 = 0;
-	
-	for (int i = 0; i < (int)num1; i++) {
-		for (int j = 0; j < (int)num2; j++) {
-			if (cfg1[i].reg == cfg2[j].reg) {
-				(*common1)++;
-				break;
-			}
-		}
-	}
-	
-	for (int i = 0; i < (int)num2; i++) {
-		for (int j = 0; j < (int)num1; j++) {
-			if (cfg2[i].reg == cfg1[j].reg) {
-				(*common2)++;
-				break;
-			}
-		}
+static uint32_t ddrc_table_crc(const struct ddrc_table *t) {
+	uint32_t crc = 0;
+
+	for (unsigned int i = 0; i < t->num; i++) {
+		crc = compute_crc32(crc, (const uint8_t *)&t->reg[i], sizeof(t->reg[i]));
+		crc = compute_crc32(crc, (const uint8_t *)&t->val[i], sizeof(t->val[i]));
 	}
-	
-	return (*common1 == *common2) ? 0 : -1;
+	return crc;
 }
 
 /**
- * @brief Extract common registers into new arrays for DDRPHY
+ * @brief CRC32 of a DDRPHY table in its packed struct ddrphy_cfg_param layout
  */
-static void extract_common_ddrphy(const struct ddrphy_cfg_param *cfg1, unsigned int num1,
-                                   const struct ddrphy_cfg_param *cfg2, unsigned int num2,
-                                   struct ddrphy_cfg_param *common1, struct ddrphy_cfg_param *common2) {
-	unsigned int idx1 = 0, idx2 = 0;
-	
-	for (int i = 0; i < (int)num1; i++) {
-		for (int j = 0; j < (int)num2; j++) {
-			if (cfg1[i].reg == cfg2[j].reg) {
-				common1[idx1++] = cfg1[i];
-				break;
-			}
-		}
+static uint32_t phy_table_crc(const struct phy_table *t) {
+	uint32_t crc = 0;
+
+	for (unsigned int i = 0; i < t->num; i++) {
+		crc = compute_crc32(crc, (const uint8_t *)&t->reg[i], sizeof(t->reg[i]));
+		crc = compute_crc32(crc, (const uint8_t *)&t->val[i], sizeof(t->val[i]));
 	}
-	
-	for (int i = 0; i < (int)num2; i++) {
-		for (int j = 0; j < (int)num1; j++) {
-			if (cfg2[i].reg == cfg1[j].reg) {
-				common2[idx2++] = cfg2[i];
-				break;
-			}
-		}
+	return crc;
+}
+
+static void timing_tables_free(struct timing_tables *tt) {
+	ddrc_table_free(&tt->ddrc_cfg);
+	for (unsigned int i = 0; tt->fsp_ddrc_cfg && i < tt->fsp_cfg_num; i++) {
+		ddrc_table_free(&tt->fsp_ddrc_cfg[i]);
 	}
+	phy_table_free(&tt->ddrphy_cfg);
+	for (unsigned int i = 0; tt->fsp_phy_cfg && i < tt->fsp_msg_num; i++) {
+		phy_table_free(&tt->fsp_phy_cfg[i]);
+		phy_table_free(&tt->fsp_phy_msgh_cfg[i]);
+		phy_table_free(&tt->fsp_phy_pie_cfg[i]);
+	}
+	phy_table_free(&tt->trained_csr);
+	phy_table_free(&tt->pie);
+	free(tt->fsp_ddrc_cfg);
+	free(tt->fsp_phy_cfg);
+	free(tt->fsp_phy_msgh_cfg);
+	free(tt->fsp_phy_pie_cfg);
+	memset(tt, 0, sizeof(*tt));
 }
 
 /**
- * @brief Print consolidated summary based on comparison return value
- * 
- * This function interprets the standardized return values from comparison functions
- * and prints appropriate summary messages.
- * 
- * Return value scheme:
- *   -1: Different size or different register sets (structural error)
- *    0: Identical registers, same order (diff_count indicates value differences)
- *    1: Identical registers, different order (diff_count indicates value differences)
- * 
- * @param result Return value from comparison function (-1, 0, 1)
- * @param diff_count Number of value differences
- * @param indent Indentation string for formatting output
+ * @brief Convert the compared tables of a loaded configuration
+ *
+ * @return 0 on success, -1 if out of memory
  */
-static void print_comparison_summary(int result, int diff_count, const char *indent) {
-	switch (result) {
-		case -1:
-			/* Different size or register sets - error already printed */
-			/* Structural differences message now printed earlier, at the point of detection */
-			break;
-		case 0:
-			/* Same order */
-			if (diff_count == 0) {
-				print_success(indent, "Registers and values match");
-			}
-			/* Warning for value differences already printed inside comparison function */
-			break;
-		case 1:
-			/* Different order - warning already printed inside comparison function */
-			break;
-		default:
-			print_error(indent, "Unexpected comparison result %d", result);
-			break;
+static int timing_tables_build(struct timing_tables *tt, const struct dram_timing_info *t) {
+	int ret = 0;
+
+	memset(tt, 0, sizeof(*tt));
+	tt->fsp_ddrc_cfg = calloc(t->fsp_cfg_num + 1, sizeof(*tt->fsp_ddrc_cfg));
+	tt->fsp_phy_cfg = calloc(t->fsp_msg_num + 1, sizeof(*tt->fsp_phy_cfg));
+	tt->fsp_phy_msgh_cfg = calloc(t->fsp_msg_num + 1, sizeof(*tt->fsp_phy_msgh_cfg));
+	tt->fsp_phy_pie_cfg = calloc(t->fsp_msg_num + 1, sizeof(*tt->fsp_phy_pie_cfg));
+	if (!tt->fsp_ddrc_cfg || !tt->fsp_phy_cfg || !tt->fsp_phy_msgh_cfg || !tt->fsp_phy_pie_cfg) {
+		timing_tables_free(tt);
+		return -1;
+	}
+	tt->fsp_cfg_num = t->fsp_cfg_num;
+	tt->fsp_msg_num = t->fsp_msg_num;
+
+	ret |= ddrc_table_load(&tt->ddrc_cfg, t->ddrc_cfg, t->ddrc_cfg_num);
+	for (unsigned int i = 0; i < t->fsp_cfg_num; i++) {
+		ret |= ddrc_table_load(&tt->fsp_ddrc_cfg[i], t->fsp_cfg[i].ddrc_cfg, t->fsp_cfg[i].ddrc_cfg_num);
+	}
+	ret |= phy_table_load(&tt->ddrphy_cfg, t->ddrphy_cfg, t->ddrphy_cfg_num);
+	for (unsigned int i = 0; i < t->fsp_msg_num; i++) {
+		const struct dram_fsp_msg *msg = &t->fsp_msg[i];
+		ret |= phy_table_load(&tt->fsp_phy_cfg[i], msg->fsp_phy_cfg, msg->fsp_phy_cfg_num);
+		ret |= phy_table_load(&tt->fsp_phy_msgh_cfg[i], msg->fsp_phy_msgh_cfg, msg->fsp_phy_msgh_cfg_num);
+		ret |= phy_table_load(&tt->fsp_phy_pie_cfg[i], msg->fsp_phy_pie_cfg, msg->fsp_phy_pie_cfg_num);
+	}
+	ret |= phy_table_load(&tt->trained_csr, t->ddrphy_trained_csr, t->ddrphy_trained_csr_num);
+	ret |= phy_table_load(&tt->pie, t->ddrphy_pie, t->ddrphy_pie_num);
+
+	if (ret) {
+		timing_tables_free(tt);
+		return -1;
 	}
+
+	return 0;
 }
 
-/* Structure to hold duplicate register information */
-struct duplicate_info {
-	unsigned int reg;
-	unsigned int indices[64];  /* Max 64 duplicate occurrences */
-	unsigned int values[64];
-	unsigned int count;
+/* ============================================================================
+ * Register index
+ * ============================================================================
+ *
+ * Open addressing hash map from register address to the position of its
+ * first occurrence in a register column, used to tell in constant time
+ * whether a register of one side is present on the other side and where.
+ * Slots hold positions; REG_INDEX_NONE marks free slots and absent
+ * registers.
+ */
+
+#define REG_INDEX_NONE 0xffffffffu
+
+struct reg_index {
+	const uint32_t *reg;        /* indexed register column */
+	unsigned int *slots;        /* positions in reg */
+	unsigned int mask;
 };
 
+static unsigned int reg_index_slot(const struct reg_index *index, unsigned int reg) {
+	return (reg * 0x9e3779b1u) & index->mask;
+}
+
 /**
- * @brief Find duplicate registers in ddrc_cfg_param array
- * 
- * @param cfg Configuration array to check
- * @param num Number of entries in array
- * @param dups Output array to store duplicate info
- * @param max_dups Maximum number of duplicates to store
- * @return Number of duplicate register addresses found
- */
-static int find_duplicates_ddrc(const struct ddrc_cfg_param *cfg, unsigned int num,
-                                 struct duplicate_info *dups, int max_dups) {
-	int dup_count = 0;
-	int *processed = calloc(num, sizeof(int));
-	
-	if (!processed) {
-		return 0;
+ * @brief Index the num registers of a register column, in scratch memory
+ *
+ * @return 0 on success, -1 if out of memory
+ */
+static int reg_index_init(struct reg_index *index, const uint32_t *reg, unsigned int num) {
+	unsigned int size = 16;
+
+	/* Keep the table at most half full */
+	while (size < 2 * (unsigned long)num) {
+		size *= 2;
 	}
-	
-	for (unsigned int i = 0; i < num && dup_count < max_dups; i++) {
-		if (processed[i]) continue;
-		
-		dups[dup_count].reg = cfg[i].reg;
-		dups[dup_count].indices[0] = i;
-		dups[dup_count].values[0] = cfg[i].val;
-		dups[dup_count].count = 1;
-		
-		for (unsigned int j = i + 1; j < num; j++) {
-			if (cfg[i].reg == cfg[j].reg && dups[dup_count].count < 64) {
-				dups[dup_count].indices[dups[dup_count].count] = j;
-				dups[dup_count].values[dups[dup_count].count] = cfg[j].val;
-				dups[dup_count].count++;
-				processed[j] = 1;
-			}
+
+	memset(index, 0, sizeof(*index));
+	index->slots = scratch_alloc(size * sizeof(*index->slots));
+	if (!index->slots) {
+		return -1;
+	}
+	memset(index->slots, 0xff, size * sizeof(*index->slots));
+	index->reg = reg;
+	index->mask = size - 1;
+
+	/* Insert in order and keep the first occurrence of each register */
+	for (unsigned int i = 0; i < num; i++) {
+		unsigned int slot = reg_index_slot(index, reg[i]);
+
+		while (index->slots[slot] != REG_INDEX_NONE && reg[index->slots[slot]] != reg[i]) {
+			slot = (slot + 1) & index->mask;
 		}
-		
-		if (dups[dup_count].count > 1) {
-			dup_count++;
+		if (index->slots[slot] == REG_INDEX_NONE) {
+			index->slots[slot] = i;
 		}
 	}
-	
-	free(processed);
-	return dup_count;
+
+	return 0;
 }
 
 /**
- * @brief Find duplicate registers in ddrphy_cfg_param array
- * 
- * @param cfg Configuration array to check
- * @param num Number of entries in array
- * @param dups Output array to store duplicate info
- * @param max_dups Maximum number of duplicates to store
- * @return Number of duplicate register addresses found
- */
-static int find_duplicates_ddrphy(const struct ddrphy_cfg_param *cfg, unsigned int num,
-                                   struct duplicate_info *dups, int max_dups) {
-	int dup_count = 0;
-	int *processed = calloc(num, sizeof(int));
-	
-	if (!processed) {
-		return 0;
-	}
-	
-	for (unsigned int i = 0; i < num && dup_count < max_dups; i++) {
-		if (processed[i]) continue;
-		
-		dups[dup_count].reg = cfg[i].reg;
-		dups[dup_count].indices[0] = i;
-		dups[dup_count].values[0] = cfg[i].val;
-		dups[dup_count].count = 1;
-		
-		for (unsigned int j = i + 1; j < num; j++) {
-			if (cfg[i].reg == cfg[j].reg && dups[dup_count].count < 64) {
-				dups[dup_count].indices[dups[dup_count].count] = j;
-				dups[dup_count].values[dups[dup_count].count] = cfg[j].val;
-				dups[dup_count].count++;
-				processed[j] = 1;
-			}
-		}
-		
-		if (dups[dup_count].count > 1) {
-			dup_count++;
+ * @brief Position of the first occurrence of reg, REG_INDEX_NONE if absent
+ */
+static unsigned int reg_index_find(const struct reg_index *index, unsigned int reg) {
+	unsigned int slot = reg_index_slot(index, reg);
+
+	while (index->slots[slot] != REG_INDEX_NONE) {
+		if (index->reg[index->slots[slot]] == reg) {
+			return index->slots[slot];
 		}
+		slot = (slot + 1) & index->mask;
 	}
-	
-	free(processed);
-	return dup_count;
+
+	return REG_INDEX_NONE;
 }
 
-/**
- * @brief Print duplicate registers side-by-side for DDRC
+static int reg_index_contains(const struct reg_index *index, unsigned int reg) {
+	return reg_index_find(index, reg) != REG_INDEX_NONE;
+}
+
+/*
+ * Split of two register arrays into the entries whose register is present
+ * on the other side (common) and the rest (unique). member1/member2 are
+ * bitmaps over the positions of each side; the common entries are also
+ * copied out in their original order, into the ddrc or phy pair of tables
+ * matching the arrays' type. Everything lives in scratch memory.
  */
-static void print_duplicates_ddrc_sidebyside(const struct duplicate_info *left_dups, int left_count,
-                                              const struct duplicate_info *right_dups, int right_count,
-                                              const char *indent) {
-	if (left_count == 0 && right_count == 0) {
-		return;
-	}
-	
-	print_info(indent, "Duplicate registers:");
-	printf("%s  LEFT                                   RIGHT\n", indent);
-	printf("%s  ─────────────────────────────────────  ─────────────────────────────────────\n", indent);
-	
-	int max_count = left_count > right_count ? left_count : right_count;
-	
-	for (int i = 0; i < max_count; i++) {
-		char left_buf[50] = "";
-		char right_buf[50] = "";
-		
-		if (i < left_count) {
-			snprintf(left_buf, sizeof(left_buf), "0x%08x (%u times)",
-			         left_dups[i].reg, left_dups[i].count);
-		}
-		
-		if (i < right_count) {
-			snprintf(right_buf, sizeof(right_buf), "0x%08x (%u times)",
-			         right_dups[i].reg, right_dups[i].count);
-		}
-		
-		printf("%s  %-37s  %-37s\n", indent, left_buf, right_buf);
+struct common_set {
+	uint64_t *member1;
+	uint64_t *member2;
+	unsigned int count1;
+	unsigned int count2;
+	struct ddrc_table ddrc1;
+	struct ddrc_table ddrc2;
+	struct phy_table phy1;
+	struct phy_table phy2;
+};
+
+#define BITMAP_WORDS(n) (((n) + 63) / 64)
+
+static int test_bit(const uint64_t *bitmap, unsigned int i) {
+	return (bitmap[i / 64] >> (i % 64)) & 1;
+}
+
+static void set_bit(uint64_t *bitmap, unsigned int i) {
+	bitmap[i / 64] |= (uint64_t)1 << (i % 64);
+}
+
+/**
+ * @brief Position of the next unique entry at or after pos, num if none
+ */
+static unsigned int next_unique(const uint64_t *member, unsigned int num, unsigned int pos) {
+	while (pos < num && test_bit(member, pos)) {
+		pos++;
 	}
+	return pos;
 }
 
+/* ============================================================================
+ * PHY register index
+ * ============================================================================
+ *
+ * PHY registers are 20-bit addresses (FMT_PHY_REG), so presence is kept as
+ * one bit per possible register (128 KiB) instead of hashing. rank[w] holds
+ * the number of registers present below word w, which turns a register into
+ * a dense slot number, and first[slot] is the position of the register's
+ * first occurrence. Out-of-range registers, which valid tables do not have,
+ * are kept in a short list and searched linearly.
+ */
+
+#define PHY_REG_SPACE (1u << 20)
+#define PHY_INDEX_NONE 0xffffffffu
+
+struct phy_index {
+	const uint32_t *reg;        /* indexed register column */
+	uint64_t *present;          /* PHY_REG_SPACE bits */
+	unsigned int *rank;         /* registers present before each word */
+	unsigned int *first;        /* per slot: first position in cfg */
+	unsigned int *overflow;     /* positions of registers >= PHY_REG_SPACE */
+	unsigned int num_overflow;
+};
+
 /**
- * @brief Print duplicate registers side-by-side for DDRPHY
+ * @brief Index the num registers of a PHY register column, in scratch memory
+ *
+ * @return 0 on success, -1 if out of memory
  */
-static void print_duplicates_ddrphy_sidebyside(const struct duplicate_info *left_dups, int left_count,
-                                                const struct duplicate_info *right_dups, int right_count,
-                                                const char *indent) {
-	if (left_count == 0 && right_count == 0) {
-		return;
+static int phy_index_init(struct phy_index *index, const uint32_t *reg, unsigned int num) {
+	unsigned int words = PHY_REG_SPACE / 64;
+	unsigned int slots = 0;
+
+	memset(index, 0, sizeof(*index));
+	index->reg = reg;
+	index->present = scratch_calloc(words, sizeof(*index->present));
+	index->rank = scratch_alloc(words * sizeof(*index->rank));
+	index->overflow = scratch_alloc((num + 1) * sizeof(*index->overflow));
+	if (!index->present || !index->rank || !index->overflow) {
+		return -1;
 	}
-	
-	print_info(indent, "Duplicate registers:");
-	printf("%s  LEFT                                   RIGHT\n", indent);
-	printf("%s  ─────────────────────────────────────  ─────────────────────────────────────\n", indent);
-	
-	int max_count = left_count > right_count ? left_count : right_count;
-	
-	for (int i = 0; i < max_count; i++) {
-		char left_buf[50] = "";
-		char right_buf[50] = "";
-		
-		if (i < left_count) {
-			snprintf(left_buf, sizeof(left_buf), "0x%05x (%u times)",
-			         left_dups[i].reg, left_dups[i].count);
+
+	for (unsigned int i = 0; i < num; i++) {
+		if (reg[i] < PHY_REG_SPACE) {
+			set_bit(index->present, reg[i]);
+		} else {
+			index->overflow[index->num_overflow++] = i;
 		}
-		
-		if (i < right_count) {
-			snprintf(right_buf, sizeof(right_buf), "0x%05x (%u times)",
-			         right_dups[i].reg, right_dups[i].count);
+	}
+
+	for (unsigned int w = 0; w < words; w++) {
+		index->rank[w] = slots;
+		slots += __builtin_popcountll(index->present[w]);
+	}
+
+	index->first = scratch_alloc((slots + 1) * sizeof(*index->first));
+	if (!index->first) {
+		return -1;
+	}
+	memset(index->first, 0xff, (slots + 1) * sizeof(*index->first));
+
+	/* Walk backwards so the first occurrence is stored last */
+	for (unsigned int i = num; i-- > 0; ) {
+		unsigned int r = reg[i];
+		if (r < PHY_REG_SPACE) {
+			uint64_t below = index->present[r / 64] & (((uint64_t)1 << (r % 64)) - 1);
+			index->first[index->rank[r / 64] + __builtin_popcountll(below)] = i;
 		}
-		
-		printf("%s  %-37s  %-37s\n", indent, left_buf, right_buf);
 	}
+
+	return 0;
 }
 
 /**
- * @brief Check if duplicates interfere with value differences and warn about them
- * 
- * @param cfg1 Left configuration array
- * @param cfg2 Right configuration array
- * @param num Number of entries (must be same for both)
- * @param left_dups Left duplicate info array
- * @param left_dup_count Number of left duplicates
- * @param right_dups Right duplicate info array
- * @param right_dup_count Number of right duplicates
- * @param indent Indentation for output
- * @param is_ddrc True for DDRC (32-bit regs), false for DDRPHY (20-bit regs)
- */
-static void check_duplicate_interference(const void *cfg1, const void *cfg2, unsigned int num,
-                                         const struct duplicate_info *left_dups, int left_dup_count,
-                                         const struct duplicate_info *right_dups, int right_dup_count,
-                                         const char *indent, int is_ddrc) {
-	int interference_found = 0;
-	unsigned int reported_regs[100];  /* Track which registers we've already reported */
-	int reported_count = 0;
-	
-	/* Check both left and right duplicates, but report each register only once */
-	for (int side = 0; side < 2; side++) {
-		const struct duplicate_info *dups = (side == 0) ? left_dups : right_dups;
-		int dup_count = (side == 0) ? left_dup_count : right_dup_count;
-		
-		for (int d = 0; d < dup_count; d++) {
-			unsigned int dup_reg = dups[d].reg;
-			
-			/* Check if we already reported this register */
-			int already_reported = 0;
-			for (int r = 0; r < reported_count; r++) {
-				if (reported_regs[r] == dup_reg) {
-					already_reported = 1;
-					break;
-				}
-			}
-			if (already_reported) continue;
-			
-			/* Check if this duplicate register has value differences */
-			for (unsigned int i = 0; i < num; i++) {
-				unsigned int reg_i, val1, val2;
-				
-				if (is_ddrc) {
-					const struct ddrc_cfg_param *c1 = (const struct ddrc_cfg_param *)cfg1;
-					const struct ddrc_cfg_param *c2 = (const struct ddrc_cfg_param *)cfg2;
-					reg_i = c1[i].reg;
-					val1 = c1[i].val;
-					val2 = c2[i].val;
-				} else {
-					const struct ddrphy_cfg_param *c1 = (const struct ddrphy_cfg_param *)cfg1;
-					const struct ddrphy_cfg_param *c2 = (const struct ddrphy_cfg_param *)cfg2;
-					reg_i = c1[i].reg;
-					val1 = c1[i].val;
-					val2 = c2[i].val;
-				}
-				
-				if (reg_i == dup_reg && val1 != val2) {
-					if (!interference_found) {
-						print_warning(indent, "Duplicate registers involved in value differences:");
-						interference_found = 1;
-					}
-					
-					/* Print the duplicate register with all its instances */
-					if (is_ddrc) {
-						printf("%s    Reg 0x%08x: duplicated %u times at indices:", indent, dup_reg, dups[d].count);
-					} else {
-						printf("%s    Reg 0x%05x: duplicated %u times at indices:", indent, dup_reg, dups[d].count);
-					}
-					for (unsigned int idx = 0; idx < dups[d].count; idx++) {
-						printf(" [%u]", dups[d].indices[idx]);
-					}
-					printf("\n");
-					
-					/* Show the values at each duplicate location */
-					if (is_ddrc) {
-						const struct ddrc_cfg_param *c1 = (const struct ddrc_cfg_param *)cfg1;
-						const struct ddrc_cfg_param *c2 = (const struct ddrc_cfg_param *)cfg2;
-						for (unsigned int idx = 0; idx < dups[d].count; idx++) {
-							unsigned int pos = dups[d].indices[idx];
-							printf("%s        [%u] Left=0x%08x, Right=0x%08x\n", 
-							       indent, pos, c1[pos].val, c2[pos].val);
-						}
-					} else {
-						const struct ddrphy_cfg_param *c1 = (const struct ddrphy_cfg_param *)cfg1;
-						const struct ddrphy_cfg_param *c2 = (const struct ddrphy_cfg_param *)cfg2;
-						for (unsigned int idx = 0; idx < dups[d].count; idx++) {
-							unsigned int pos = dups[d].indices[idx];
-							printf("%s        [%u] Left=0x%04x, Right=0x%04x\n", 
-							       indent, pos, c1[pos].val, c2[pos].val);
-						}
-					}
-					
-					/* Mark this register as reported */
-					if (reported_count < 100) {
-						reported_regs[reported_count++] = dup_reg;
-					}
-					break;  /* Move to next duplicate */
-				}
+ * @brief Position of the first occurrence of reg, PHY_INDEX_NONE if absent
+ */
+static unsigned int phy_index_find(const struct phy_index *index, unsigned int reg) {
+	if (reg >= PHY_REG_SPACE) {
+		for (unsigned int k = 0; k < index->num_overflow; k++) {
+			if (index->reg[index->overflow[k]] == reg) {
+				return index->overflow[k];
 			}
 		}
+		return PHY_INDEX_NONE;
 	}
+
+	uint64_t word = index->present[reg / 64];
+	if (!((word >> (reg % 64)) & 1)) {
+		return PHY_INDEX_NONE;
+	}
+
+	return index->first[index->rank[reg / 64] + __builtin_popcountll(word & (((uint64_t)1 << (reg % 64)) - 1))];
 }
 
-/**
- * @brief Compare two ddrc_cfg_param arrays
- * 
- * @param cfg1 First configuration array
- * @param num1 Number of entries in first array
- * @param cfg2 Second configuration array
- * @param num2 Number of entries in second array
- * @param indent Indentation string for output
- * @param diff_count_p Pointer to store the number of value differences (optional, can be NULL)
- * @param print_header If non-zero, print entry count and size information
- * @return int Result code: -1 (structural error), 0 (same order), 1 (different order)
- */
-static int compare_ddrc_cfg_arrays(const struct ddrc_cfg_param *cfg1, unsigned int num1,
-                                     const struct ddrc_cfg_param *cfg2, unsigned int num2,
-                                     const char *indent, int *diff_count_p, int print_header) {
-	int i;
-	int diff_count = 0;
-	int has_error = 0;
-	int same_order = 1;
-	
-	if (print_header) {
-		uint32_t crc_left = compute_crc32((const uint8_t *)cfg1, num1 * sizeof(struct ddrc_cfg_param));
-		uint32_t crc_right = compute_crc32((const uint8_t *)cfg2, num2 * sizeof(struct ddrc_cfg_param));
-		printf("%sEntries: Left=%u, Right=%u\n", indent, num1, num2);
-		printf("%sSize:    Left=%u bytes (%.2f kB), Right=%u bytes (%.2f kB)\n",
-		       indent, num1 * 8, num1 * 8 / 1024.0, num2 * 8, num2 * 8 / 1024.0);
-		printf("%sCRC:     Left=0x%08x, Right=0x%08x\n", indent, crc_left, crc_right);
+static int phy_index_contains(const struct phy_index *index, unsigned int reg) {
+	return phy_index_find(index, reg) != PHY_INDEX_NONE;
+}
+
+/* ============================================================================
+ * Register sequence diff
+ * ============================================================================
+ *
+ * Myers' O(ND) difference algorithm in its linear-space form: the middle
+ * snake of the edit graph is found by searching forwards and backwards at
+ * the same time and the two halves around it are solved recursively. The
+ * result is the list of runs of registers that keep their relative order
+ * (a longest common subsequence); whatever lies between two runs was moved.
+ * Configurations that are mostly in order have a small D, so this is close
+ * to linear in practice.
+ */
+
+/* Run of registers in the same relative order on both sides */
+struct diff_run {
+	unsigned int x;             /* start in the left sequence */
+	unsigned int y;             /* start in the right sequence */
+	unsigned int len;
+};
+
+struct diff_ctx {
+	const unsigned int *a;
+	const unsigned int *b;
+	int *vf;                    /* furthest x per diagonal, forward search */
+	int *vb;                    /* furthest x per diagonal, backward search (from the end) */
+	struct diff_run *runs;
+	unsigned int num_runs;
+};
+
+static void diff_add_run(struct diff_ctx *ctx, int x, int y, int len) {
+	struct diff_run *last = ctx->num_runs ? &ctx->runs[ctx->num_runs - 1] : NULL;
+
+	if (len <= 0) {
+		return;
 	}
-	
-	if (num1 != num2) {
-		print_warning(indent, "Structural differences found");
-		has_error = 1;
-		
-		/* Find and display unique registers side-by-side */
-		find_and_display_unique_ddrc(cfg1, num1, cfg2, num2, indent);
-		
-		/* Compare common registers */
-		printf("\n");
-		printf("%s┌─ Comparing common registers ──────────────────────────────┐\n", indent);
-		
-		/* Count common registers */
-		unsigned int common_count1, common_count2;
-		if (count_common_ddrc(cfg1, num1, cfg2, num2, &common_count1, &common_count2) != 0) {
-			print_error(indent, "Internal error: common register counts don't match (%u vs %u)", common_count1, common_count2);
-			printf("%s└──────────────────────────────────────────────────────────┘\n", indent);
-			return -1;
+	if (last && last->x + last->len == (unsigned int)x && last->y + last->len == (unsigned int)y) {
+		last->len += len;
+		return;
+	}
+	ctx->runs[ctx->num_runs].x = x;
+	ctx->runs[ctx->num_runs].y = y;
+	ctx->runs[ctx->num_runs].len = len;
+	ctx->num_runs++;
+}
+
+/**
+ * @brief Find the middle snake of a[0..n) against b[0..m)
+ *
+ * Both sequences are non-empty. The snake runs from (*sx, *sy) to (*ex, *ey).
+ */
+static void diff_middle_snake(const struct diff_ctx *ctx, const unsigned int *a, int n,
+                              const unsigned int *b, int m,
+                              int *sx, int *sy, int *ex, int *ey) {
+	int delta = n - m;
+	int odd = delta & 1;
+	int max = (n + m + 1) / 2;
+	int *vf = ctx->vf + max + 1;
+	int *vb = ctx->vb + max + 1;
+
+	vf[1] = 0;
+	vb[1] = 0;
+
+	for (int d = 0; d <= max; d++) {
+		/* Forward, from (0, 0) */
+		for (int k = -d; k <= d; k += 2) {
+			int x = (k == -d || (k != d && vf[k - 1] < vf[k + 1])) ? vf[k + 1] : vf[k - 1] + 1;
+			int y = x - k;
+			int x_start = x, y_start = y;
+
+			while (x < n && y < m && a[x] == b[y]) {
+				x++;
+				y++;
+			}
+			vf[k] = x;
+
+			if (odd && delta - k >= -(d - 1) && delta - k <= d - 1 && x + vb[delta - k] >= n) {
+				*sx = x_start;
+				*sy = y_start;
+				*ex = x;
+				*ey = y;
+				return;
+			}
 		}
-		
-		if (common_count1 > 0) {
-			/* Allocate temporary arrays for common registers */
-			struct ddrc_cfg_param *common1 = malloc(common_count1 * sizeof(struct ddrc_cfg_param));
-			struct ddrc_cfg_param *common2 = malloc(common_count2 * sizeof(struct ddrc_cfg_param));
-			
-			if (common1 && common2) {
-				/* Extract common registers */
-				extract_common_ddrc(cfg1, num1, cfg2, num2, common1, common2);
-				
-				char nested_indent[32];
-				snprintf(nested_indent, sizeof(nested_indent), "%s  ", indent);
-				
-				/* Recursively compare common registers */
-				int common_result = compare_ddrc_cfg_arrays(common1, common_count1, 
-				                                            common2, common_count2,
-				                                            nested_indent, diff_count_p, 1);
-				
-				/* Print summary for common register comparison */
-				int common_diff_count = diff_count_p ? *diff_count_p : 0;
-				print_comparison_summary(common_result, common_diff_count, nested_indent);
-				printf("%s└──────────────────────────────────────────────────────────┘\n", indent);
-				
-				free(common1);
-				free(common2);
-				
-				/* Still return -1 due to structural difference, but we showed common register comparison */
-				return -1;
-			} else {
-				print_error(indent, "Memory allocation failed for common register comparison");
-				if (common1) free(common1);
-				if (common2) free(common2);
+
+		/* Backward, from (n, m), in reversed coordinates */
+		for (int k = -d; k <= d; k += 2) {
+			int x = (k == -d || (k != d && vb[k - 1] < vb[k + 1])) ? vb[k + 1] : vb[k - 1] + 1;
+			int y = x - k;
+			int x_start = x, y_start = y;
+
+			while (x < n && y < m && a[n - 1 - x] == b[m - 1 - y]) {
+				x++;
+				y++;
+			}
+			vb[k] = x;
+
+			if (!odd && delta - k >= -d && delta - k <= d && x + vf[delta - k] >= n) {
+				*sx = n - x;
+				*sy = m - y;
+				*ex = n - x_start;
+				*ey = m - y_start;
+				return;
 			}
-		} else {
-			print_info(indent, "No common registers found");
 		}
-		
-		return -1; /* Length mismatch is structural error */
 	}
-	
-	/* Same length - check if registers are in same order */
-	for (i = 0; i < (int)num1; i++) {
-		if (cfg1[i].reg != cfg2[i].reg) {
-			same_order = 0;
-			break;
+}
+
+static void diff_recurse(struct diff_ctx *ctx, int x0, int x1, int y0, int y1) {
+	const unsigned int *a = ctx->a;
+	const unsigned int *b = ctx->b;
+	int prefix = 0, suffix = 0;
+
+	while (x0 + prefix < x1 && y0 + prefix < y1 && a[x0 + prefix] == b[y0 + prefix]) {
+		prefix++;
+	}
+	diff_add_run(ctx, x0, y0, prefix);
+	x0 += prefix;
+	y0 += prefix;
+
+	while (x1 - suffix > x0 && y1 - suffix > y0 && a[x1 - suffix - 1] == b[y1 - suffix - 1]) {
+		suffix++;
+	}
+
+	/* With the common ends stripped, D >= 2 and both halves are smaller */
+	if (x0 < x1 - suffix && y0 < y1 - suffix) {
+		int sx = 0, sy = 0, ex = 0, ey = 0;
+
+		diff_middle_snake(ctx, a + x0, x1 - suffix - x0, b + y0, y1 - suffix - y0,
+		                  &sx, &sy, &ex, &ey);
+		diff_recurse(ctx, x0, x0 + sx, y0, y0 + sy);
+		diff_add_run(ctx, x0 + sx, y0 + sy, ex - sx);
+		diff_recurse(ctx, x0 + ex, x1 - suffix, y0 + ey, y1 - suffix);
+	}
+
+	diff_add_run(ctx, x1 - suffix, y1 - suffix, suffix);
+}
+
+/**
+ * @brief Diff two register address sequences
+ *
+ * @param num_runs Number of runs returned
+ * @return Runs in order, in scratch memory, NULL if out of memory
+ */
+static struct diff_run *diff_registers(const unsigned int *a, unsigned int n,
+                                       const unsigned int *b, unsigned int m,
+                                       unsigned int *num_runs) {
+	struct diff_ctx ctx;
+	size_t vsize = (n + m + 1) / 2 + 3;
+
+	ctx.a = a;
+	ctx.b = b;
+	ctx.num_runs = 0;
+	ctx.vf = scratch_alloc(2 * vsize * sizeof(int));
+	ctx.vb = scratch_alloc(2 * vsize * sizeof(int));
+	ctx.runs = scratch_alloc(((n < m ? n : m) + 1) * sizeof(struct diff_run));
+	if (!ctx.vf || !ctx.vb || !ctx.runs) {
+		return NULL;
+	}
+
+	diff_recurse(&ctx, 0, n, 0, m);
+
+	*num_runs = ctx.num_runs;
+
+	return ctx.runs;
+}
+
+/*
+ * Block moves
+ *
+ * Whole groups of registers emitted elsewhere by a newer tool version show
+ * up in the diff as a left-only block in one place and a right-only block
+ * in another. Such pairs are found by fingerprinting every MOVE_MIN_LEN
+ * window of unmatched left registers with a Rabin-Karp rolling hash and
+ * sliding the same window over the unmatched right registers; a hit is
+ * verified and extended as far as both sides agree. Expected cost is linear.
+ */
+
+/* Shortest run reported as a moved block */
+#define MOVE_MIN_LEN 4
+
+/* Hash base, mod 2^64 */
+#define MOVE_HASH_BASE 0x100000001b3ULL
+
+/* move1/move2 values besides a move number */
+#define MOVE_NONE (-1)              /* unmatched, not part of a move */
+#define MOVE_KEPT (-2)              /* in a run kept in order */
+
+struct block_move {
+	unsigned int x;             /* start in the left sequence */
+	unsigned int y;             /* start in the right sequence */
+	unsigned int len;
+	int reported;
+};
+
+/**
+ * @brief Rolling hashes of every MOVE_MIN_LEN window of a sequence
+ *
+ * @param hash Output, hash[p] for the window starting at p (n >= MOVE_MIN_LEN)
+ */
+static void move_window_hashes(const unsigned int *a, unsigned int n, uint64_t *hash) {
+	uint64_t h = 0, top = 1;
+
+	for (unsigned int t = 1; t < MOVE_MIN_LEN; t++) {
+		top *= MOVE_HASH_BASE;
+	}
+	for (unsigned int t = 0; t < MOVE_MIN_LEN; t++) {
+		h = h * MOVE_HASH_BASE + a[t];
+	}
+	hash[0] = h;
+	for (unsigned int p = 1; p + MOVE_MIN_LEN <= n; p++) {
+		h = (h - a[p - 1] * top) * MOVE_HASH_BASE + a[p + MOVE_MIN_LEN - 1];
+		hash[p] = h;
+	}
+}
+
+/**
+ * @brief Pair left-only and right-only runs of the diff into block moves
+ *
+ * @param move1 Output per left position: move number, MOVE_NONE or MOVE_KEPT
+ * @param move2 Output per right position, likewise
+ * @param num_moves Number of moves returned
+ * @return Moves in order of their right position, in scratch memory, NULL if out of memory
+ */
+static struct block_move *find_block_moves(const unsigned int *a, unsigned int n,
+                                           const unsigned int *b, unsigned int m,
+                                           const struct diff_run *runs, unsigned int num_runs,
+                                           int *move1, int *move2, unsigned int *num_moves) {
+	struct block_move *moves = scratch_alloc((m / MOVE_MIN_LEN + 1) * sizeof(*moves));
+	uint64_t *hash1 = scratch_alloc((n + 1) * sizeof(*hash1));
+	uint64_t *hash2 = scratch_alloc((m + 1) * sizeof(*hash2));
+	unsigned int *free1 = scratch_alloc((n + 1) * sizeof(*free1));
+	unsigned int *free2 = scratch_alloc((m + 1) * sizeof(*free2));
+	unsigned int *slots = NULL;
+	unsigned int slot_mask = 0, size = 16;
+
+	*num_moves = 0;
+	if (!moves || !hash1 || !hash2 || !free1 || !free2) {
+		return NULL;
+	}
+
+	for (unsigned int i = 0; i < n; i++) move1[i] = MOVE_NONE;
+	for (unsigned int j = 0; j < m; j++) move2[j] = MOVE_NONE;
+	for (unsigned int r = 0; r < num_runs; r++) {
+		for (unsigned int t = 0; t < runs[r].len; t++) {
+			move1[runs[r].x + t] = MOVE_KEPT;
+			move2[runs[r].y + t] = MOVE_KEPT;
 		}
 	}
-	
-	if (same_order) {
-		/* Same order - count value differences first */
-		for (i = 0; i < (int)num1; i++) {
-			if (cfg1[i].val != cfg2[i].val) {
-				diff_count++;
-			}
+	if (n < MOVE_MIN_LEN || m < MOVE_MIN_LEN) {
+		return moves;
+	}
+
+	/* Length of the unmatched stretch starting at each position */
+	free1[n] = 0;
+	for (unsigned int i = n; i-- > 0; ) {
+		free1[i] = move1[i] == MOVE_NONE ? free1[i + 1] + 1 : 0;
+	}
+	free2[m] = 0;
+	for (unsigned int j = m; j-- > 0; ) {
+		free2[j] = move2[j] == MOVE_NONE ? free2[j + 1] + 1 : 0;
+	}
+
+	/* Index the left windows lying entirely in unmatched stretches */
+	while (size < 2 * n) {
+		size *= 2;
+	}
+	slots = scratch_calloc(size, sizeof(*slots));
+	if (!slots) {
+		return NULL;
+	}
+	slot_mask = size - 1;
+	move_window_hashes(a, n, hash1);
+	move_window_hashes(b, m, hash2);
+	for (unsigned int p = 0; p + MOVE_MIN_LEN <= n; p++) {
+		if (free1[p] < MOVE_MIN_LEN) {
+			continue;
 		}
-		
-		/* Print summary before details */
-		if (diff_count > 0) {
-			print_info(indent, "Registers match, %d value differences", diff_count);
-			print_info(indent, "Register value differences:");
+
+		unsigned int slot = (unsigned int)(hash1[p] >> 32) & slot_mask;
+		while (slots[slot]) {
+			slot = (slot + 1) & slot_mask;
 		}
-		
-		/* Now print the details */
-		for (i = 0; i < (int)num1; i++) {
-			if (cfg1[i].val != cfg2[i].val) {
-				printf("%s    " FMT_DDRC_DIFF "\n", 
-				       indent, i, cfg1[i].reg, cfg1[i].val, cfg2[i].val);
-			}
+		slots[slot] = p + 1;
+	}
+
+	/* Slide over the right side and claim verified matches */
+	for (unsigned int q = 0; q + MOVE_MIN_LEN <= m; ) {
+		unsigned int slot = (unsigned int)(hash2[q] >> 32) & slot_mask;
+		unsigned int p = 0;
+		int found = 0;
+
+		if (free2[q] < MOVE_MIN_LEN) {
+			q++;
+			continue;
 		}
-		
-		/* Return: 0 if all match, 1 if value differences */
-		if (diff_count_p) *diff_count_p = diff_count;
-		return 0;
-	} else {
-		/* Different order - check if all registers exist in both arrays */
-		int all_present = 1;
-		
-		/* Check if all registers from left exist in right */
-		for (i = 0; i < (int)num1; i++) {
-			int j, found = 0;
-			for (j = 0; j < (int)num2; j++) {
-				if (cfg1[i].reg == cfg2[j].reg) {
-					found = 1;
-					break;
-				}
-			}
-			if (!found) {
-				if (all_present) {
-					print_error(indent, "Arrays have same length but different register sets!");
-					print_info(indent, "Registers in LEFT but not in RIGHT:");
-					all_present = 0;
-				}
-				printf("%s    [%3d] Reg 0x%08x = 0x%08x\n", indent, i, cfg1[i].reg, cfg1[i].val);
+
+		for (; slots[slot]; slot = (slot + 1) & slot_mask) {
+			unsigned int t;
+
+			p = slots[slot] - 1;
+			if (hash1[p] != hash2[q]) {
+				continue;
 			}
-		}
-		
-		/* Check if all registers from right exist in left */
-		for (i = 0; i < (int)num2; i++) {
-			int j, found = 0;
-			for (j = 0; j < (int)num1; j++) {
-				if (cfg2[i].reg == cfg1[j].reg) {
-					found = 1;
+			for (t = 0; t < MOVE_MIN_LEN; t++) {
+				if (move1[p + t] != MOVE_NONE || a[p + t] != b[q + t]) {
 					break;
 				}
 			}
-			if (!found) {
-				if (all_present) {
-					print_error(indent, "Arrays have same length but different register sets!");
-					all_present = 0;
-				}
-				if (!all_present && i == 0) {
-					print_info(indent, "Registers in RIGHT but not in LEFT:");
-				}
-				printf("%s    " FMT_DDRC_ENTRY "\n", indent, i, cfg2[i].reg, cfg2[i].val);
+			if (t == MOVE_MIN_LEN) {
+				found = 1;
+				break;
 			}
 		}
-		
-		if (!all_present) {
-			/* Different register sets - structural error */
-			return -1;
+		if (!found) {
+			q++;
+			continue;
 		}
-		
-		/* All registers present but different order - print warning first, then analyze with LCS-based diff */
-		print_warning(indent, "Registers match, different order");
-		print_reorder_header(indent);
-		
-		/* Use LCS (Longest Common Subsequence) approach to find matching blocks */
-		int i1 = 0, i2 = 0;
-		
-		while (i1 < (int)num1 && i2 < (int)num2) {
-			/* Check if registers at current positions match */
-			if (cfg1[i1].reg == cfg2[i2].reg) {
-				/* Found a matching block - scan forward to find the extent */
-				int start_i1 = i1;
-				int start_i2 = i2;
-				
-				while (i1 < (int)num1 && i2 < (int)num2 && cfg1[i1].reg == cfg2[i2].reg) {
-					i1++;
-					i2++;
-				}
-				
-#if SHOW_IDENTICAL_RANGES
-				/* Only show if more than a few registers to reduce noise */
-				if (i1 - start_i1 > 10) {
-					printf("%s  [%4d-%4d] (%d registers)           [%4d-%4d] (%d registers)\n",
-					       indent, start_i1, i1 - 1, i1 - start_i1, start_i2, i2 - 1, i2 - start_i2);
-				}
-#else
-				(void)start_i1; (void)start_i2; /* Unused when SHOW_IDENTICAL_RANGES is 0 */
-#endif
-			} else {
-				/* Registers don't match - find where blocks appear */
-				int block_start_i1 = i1;
-				
-				/* Scan forward in left to find extent of mismatched block */
-				while (i1 < (int)num1) {
-					/* Check if this register from left appears soon in right */
-					int found_soon = 0;
-					for (int check_j = i2; check_j < i2 + 50 && check_j < (int)num2; check_j++) {
-						if (cfg1[i1].reg == cfg2[check_j].reg) {
-							found_soon = 1;
-							break;
-						}
-					}
-					if (found_soon) break;
-					i1++;
-				}
-				
-				int block_start_i2 = i2;
-				
-				/* Scan forward in right to find extent of mismatched block */
-				while (i2 < (int)num2) {
-					/* Check if this register from right appears soon in left */
-					int found_soon = 0;
-					for (int check_i = i1; check_i < i1 + 50 && check_i < (int)num1; check_i++) {
-						if (cfg2[i2].reg == cfg1[check_i].reg) {
-							found_soon = 1;
-							break;
-						}
-					}
-					if (found_soon) break;
-					i2++;
-				}
-				
-				/* Display the relocated blocks side-by-side */
-				if (block_start_i1 < i1 && block_start_i2 < i2) {
-					/* Both sides have blocks - they're relocated */
-					int left_count = i1 - block_start_i1;
-					int right_count = i2 - block_start_i2;
-					int max_show = (left_count < right_count) ? right_count : left_count;
-					if (max_show > 10) max_show = 10;
-					
-					for (int k = 0; k < max_show; k++) {
-						char left_buf[DDRC_COLUMN_WIDTH] = "";
-						char right_buf[DDRC_COLUMN_WIDTH] = "";
-						
-						if (k < left_count) {
-							snprintf(left_buf, sizeof(left_buf), FMT_DDRC_ENTRY_4,
-							         block_start_i1 + k, cfg1[block_start_i1 + k].reg, cfg1[block_start_i1 + k].val);
-						}
-						if (k < right_count) {
-							snprintf(right_buf, sizeof(right_buf), FMT_DDRC_ENTRY_4,
-							         block_start_i2 + k, cfg2[block_start_i2 + k].reg, cfg2[block_start_i2 + k].val);
-						}
-						
-						print_side_by_side(left_buf, right_buf, indent, 37);
-					}
-					
-					if (left_count > 10 || right_count > 10) {
-						char left_more[DDRC_COLUMN_WIDTH] = "";
-						char right_more[DDRC_COLUMN_WIDTH] = "";
-						if (left_count > 10) {
-							snprintf(left_more, sizeof(left_more), "... (%d more)", left_count - 10);
-						}
-						if (right_count > 10) {
-							snprintf(right_more, sizeof(right_more), "... (%d more)", right_count - 10);
-						}
-						print_side_by_side(left_more, right_more, indent, 37);
-					}
-				} else if (block_start_i1 < i1) {
-					/* Only left has block */
-					int left_count = i1 - block_start_i1;
-					int show_count = (left_count < 10) ? left_count : 10;
-					
-					for (int k = 0; k < show_count; k++) {
-						printf("%s  " FMT_DDRC_ENTRY_4 "\n",
-						       indent, block_start_i1 + k, cfg1[block_start_i1 + k].reg, cfg1[block_start_i1 + k].val);
-					}
-					if (left_count > 10) {
-						printf("%s  ... (%d more)\n", indent, left_count - 10);
-					}
-				} else if (block_start_i2 < i2) {
-					/* Only right has block */
-					int right_count = i2 - block_start_i2;
-					int show_count = (right_count < 10) ? right_count : 10;
-					
-					for (int k = 0; k < show_count; k++) {
-						char right_buf[DDRC_COLUMN_WIDTH];
-						snprintf(right_buf, sizeof(right_buf), FMT_DDRC_ENTRY_4,
-						         block_start_i2 + k, cfg2[block_start_i2 + k].reg, cfg2[block_start_i2 + k].val);
-						print_side_by_side("", right_buf, indent, 37);
-					}
-					if (right_count > 10) {
-						char more_buf[DDRC_COLUMN_WIDTH];
-						snprintf(more_buf, sizeof(more_buf), "... (%d more)", right_count - 10);
-						print_side_by_side("", more_buf, indent, 37);
-					}
-				}
-			}
+
+		unsigned int len = MOVE_MIN_LEN;
+		while (p + len < n && q + len < m && move1[p + len] == MOVE_NONE &&
+		       move2[q + len] == MOVE_NONE && a[p + len] == b[q + len]) {
+			len++;
 		}
-		
-		/* Handle remaining registers at the end */
-		if (i1 < (int)num1) {
-			int remain_count = (int)num1 - i1;
-			int show_count = (remain_count < 10) ? remain_count : 10;
-			for (int k = 0; k < show_count; k++) {
-				printf("%s  " FMT_DDRC_ENTRY_4 "\n",
-				       indent, i1 + k, cfg1[i1 + k].reg, cfg1[i1 + k].val);
-			}
-			if (remain_count > 10) {
-				printf("%s  ... (%d more)\n", indent, remain_count - 10);
-			}
+
+		moves[*num_moves].x = p;
+		moves[*num_moves].y = q;
+		moves[*num_moves].len = len;
+		moves[*num_moves].reported = 0;
+		for (unsigned int t = 0; t < len; t++) {
+			move1[p + t] = *num_moves;
+			move2[q + t] = *num_moves;
+		}
+		(*num_moves)++;
+		q += len;
+	}
+
+	return moves;
+}
+
+/**
+ * @brief Report a moved block once, where it is first met
+ */
+static void print_block_move(struct block_move *move, const char *indent) {
+	if (move->reported) {
+		return;
+	}
+	fprintf(out, "%s  block [%u..%u] moved to [%u..%u] (%u registers)\n", indent,
+	        move->x, move->x + move->len - 1, move->y, move->y + move->len - 1, move->len);
+	move->reported = 1;
+}
+
+/* ============================================================================
+ * Order-insensitive comparison
+ * ============================================================================
+ *
+ * With --ignore-order both sides are sorted by (register, position) with an
+ * LSD radix sort and merged in one linear pass. Only the passes for bytes
+ * that actually vary are run, so 20-bit PHY registers take at most three
+ * 8-bit passes and DDRC registers, sharing their top bytes, usually two.
+ * Repeated writes of a register are paired in order of appearance.
+ */
+
+struct reg_pos {
+	unsigned int reg;
+	unsigned int pos;           /* position in the original array */
+};
+
+/**
+ * @brief Stable radix sort of items by register
+ *
+ * @return 0 on success, -1 if out of memory
+ */
+static int radix_sort_registers(struct reg_pos *items, unsigned int num) {
+	struct reg_pos *tmp = scratch_alloc((num + 1) * sizeof(*tmp));
+	struct reg_pos *src = items, *dst = tmp;
+	unsigned int diff_bits = 0;
+
+	if (!tmp) {
+		return -1;
+	}
+	for (unsigned int i = 1; i < num; i++) {
+		diff_bits |= items[i].reg ^ items[0].reg;
+	}
+
+	for (unsigned int shift = 0; shift < 32; shift += 8) {
+		unsigned int count[257] = { 0 };
+
+		if (!((diff_bits >> shift) & 0xff)) {
+			continue;
 		}
-		if (i2 < (int)num2) {
-			int remain_count = (int)num2 - i2;
-			int show_count = (remain_count < 10) ? remain_count : 10;
-			for (int k = 0; k < show_count; k++) {
-				char right_buf[DDRC_COLUMN_WIDTH];
-				snprintf(right_buf, sizeof(right_buf), FMT_DDRC_ENTRY_4,
-				         i2 + k, cfg2[i2 + k].reg, cfg2[i2 + k].val);
-				print_side_by_side("", right_buf, indent, DDRC_COLUMN_WIDTH - 3);
-			}
-			if (remain_count > 10) {
-				print_side_by_side("", "...", indent, DDRC_COLUMN_WIDTH - 3);
-				printf(" (%d more)\n", remain_count - 10);
-			}
+		for (unsigned int i = 0; i < num; i++) {
+			count[((src[i].reg >> shift) & 0xff) + 1]++;
 		}
-		
-		/* Count value differences first */
-		for (i = 0; i < (int)num1; i++) {
-			/* Find matching register in cfg2 */
-			int j;
-			for (j = 0; j < (int)num2; j++) {
-				if (cfg1[i].reg == cfg2[j].reg) {
-					if (cfg1[i].val != cfg2[j].val) {
-						diff_count++;
-					}
-					break;
-				}
-			}
+		for (unsigned int d = 1; d < 257; d++) {
+			count[d] += count[d - 1];
 		}
-		
-		/* Print summary and details for value differences */
-		if (diff_count > 0) {
-			print_info(indent, "Value differences: %d", diff_count);
-			print_info(indent, "Register value differences:");
-			/* Now print the details */
-			for (i = 0; i < (int)num1; i++) {
-				int j;
-				for (j = 0; j < (int)num2; j++) {
-					if (cfg1[i].reg == cfg2[j].reg) {
-						if (cfg1[i].val != cfg2[j].val) {
-							printf("%s    " FMT_DDRC_DIFF_4 "\n", 
-							       indent, i, cfg1[i].reg, cfg1[i].val, cfg2[j].val);
-						}
-						break;
-					}
-				}
-			}
+		for (unsigned int i = 0; i < num; i++) {
+			dst[count[(src[i].reg >> shift) & 0xff]++] = src[i];
 		}
-		
-		/* Return: 2 for different order (diff_count tracks value differences) */
-		if (diff_count_p) *diff_count_p = diff_count;
-		
-		return 1;
+
+		struct reg_pos *swap = src;
+		src = dst;
+		dst = swap;
 	}
+
+	if (src != items) {
+		memcpy(items, src, num * sizeof(*items));
+	}
+
+	return 0;
 }
 
+/* Result of merging two sorted sides, in scratch memory */
+struct sorted_merge {
+	struct reg_pos *sorted1;
+	struct reg_pos *sorted2;
+	unsigned int *partner1;     /* per left position: right partner or MERGE_NONE */
+	unsigned int *partner2;     /* per right position: left partner or MERGE_NONE */
+	unsigned int num_only1;     /* left entries without a partner */
+	unsigned int num_only2;
+};
+
+#define MERGE_NONE 0xffffffffu
+
 /**
- * @brief Compare two ddrphy_cfg_param arrays
- * 
- * @param cfg1 First configuration array
- * @param num1 Number of entries in first array
- * @param cfg2 Second configuration array
- * @param num2 Number of entries in second array
- * @param indent Indentation string for output
- * @param diff_count_p Pointer to store the number of value differences (optional, can be NULL)
- * @param print_header If non-zero, print entry count and size information
- * @return int Result code: -1 (structural error), 0 (same order), 1 (different order)
- */
-static int compare_ddrphy_cfg_arrays(const struct ddrphy_cfg_param *cfg1, unsigned int num1,
-                                       const struct ddrphy_cfg_param *cfg2, unsigned int num2,
-                                       const char *indent, int *diff_count_p, int print_header) {
-	int i;
-	int diff_count = 0;
-	int has_error = 0;
-	int same_order = 1;
-	
-	if (print_header) {
-		uint32_t crc_left = compute_crc32((const uint8_t *)cfg1, num1 * sizeof(struct ddrphy_cfg_param));
-		uint32_t crc_right = compute_crc32((const uint8_t *)cfg2, num2 * sizeof(struct ddrphy_cfg_param));
-		printf("%sEntries: Left=%u, Right=%u\n", indent, num1, num2);
-		printf("%sSize:    Left=%u bytes (%.2f kB), Right=%u bytes (%.2f kB)\n",
-		       indent, num1 * 6, num1 * 6 / 1024.0, num2 * 6, num2 * 6 / 1024.0);
-		printf("%sCRC:     Left=0x%08x, Right=0x%08x\n", indent, crc_left, crc_right);
+ * @brief Sort both sides (already filled into merge->sorted1/2) and merge
+ *
+ * The result is recorded per original position, so it can be reported in
+ * array order without sorting back.
+ *
+ * @return 0 on success, -1 if out of memory
+ */
+static int sorted_merge_run(struct sorted_merge *merge, unsigned int num1, unsigned int num2) {
+	unsigned int i = 0, j = 0;
+
+	merge->partner1 = scratch_alloc((num1 + 1) * sizeof(*merge->partner1));
+	merge->partner2 = scratch_alloc((num2 + 1) * sizeof(*merge->partner2));
+	if (!merge->partner1 || !merge->partner2 ||
+	    radix_sort_registers(merge->sorted1, num1) != 0 ||
+	    radix_sort_registers(merge->sorted2, num2) != 0) {
+		return -1;
 	}
-	
-	if (num1 != num2) {
-		print_warning(indent, "Structural differences found");
-		has_error = 1;
-		
-		/* Find and display unique registers side-by-side */
-		find_and_display_unique_ddrphy(cfg1, num1, cfg2, num2, indent);
-		
-		/* Compare common registers */
-		printf("\n");
-		printf("%s┌─ Comparing common registers ──────────────────────────────┐\n", indent);
-		
-		/* Count common registers */
-		unsigned int common_count1, common_count2;
-		if (count_common_ddrphy(cfg1, num1, cfg2, num2, &common_count1, &common_count2) != 0) {
-			print_error(indent, "Internal error: common register counts don't match (%u vs %u)", common_count1, common_count2);
-			printf("%s└──────────────────────────────────────────────────────────┘\n", indent);
-			return -1;
-		}
-		
-		if (common_count1 > 0) {
-			/* Allocate temporary arrays for common registers */
-			struct ddrphy_cfg_param *common1 = malloc(common_count1 * sizeof(struct ddrphy_cfg_param));
-			struct ddrphy_cfg_param *common2 = malloc(common_count2 * sizeof(struct ddrphy_cfg_param));
-			
-			if (common1 && common2) {
-				/* Extract common registers */
-				extract_common_ddrphy(cfg1, num1, cfg2, num2, common1, common2);
-				
-				char nested_indent[32];
-				snprintf(nested_indent, sizeof(nested_indent), "%s  ", indent);
-				
-				/* Recursively compare common registers */
-				int common_result = compare_ddrphy_cfg_arrays(common1, common_count1, 
-				                                              common2, common_count2,
-				                                              nested_indent, diff_count_p, 1);
-				
-				/* Print summary for common register comparison */
-				int common_diff_count = diff_count_p ? *diff_count_p : 0;
-				print_comparison_summary(common_result, common_diff_count, nested_indent);
-				printf("%s└──────────────────────────────────────────────────────────┘\n", indent);
-				
-				free(common1);
-				free(common2);
-				
-				/* Still return -1 due to structural difference, but we showed common register comparison */
-				return -1;
-			} else {
-				print_error(indent, "Memory allocation failed for common register comparison");
-				if (common1) free(common1);
-				if (common2) free(common2);
-			}
+
+	while (i < num1 || j < num2) {
+		if (j == num2 || (i < num1 && merge->sorted1[i].reg < merge->sorted2[j].reg)) {
+			merge->partner1[merge->sorted1[i++].pos] = MERGE_NONE;
+			merge->num_only1++;
+		} else if (i == num1 || merge->sorted2[j].reg < merge->sorted1[i].reg) {
+			merge->partner2[merge->sorted2[j++].pos] = MERGE_NONE;
+			merge->num_only2++;
 		} else {
-			print_info(indent, "No common registers found");
+			merge->partner1[merge->sorted1[i].pos] = merge->sorted2[j].pos;
+			merge->partner2[merge->sorted2[j].pos] = merge->sorted1[i].pos;
+			i++;
+			j++;
 		}
-		
-		return -1; /* Length mismatch is structural error */
 	}
-	
-	/* Same length - check if registers are in same order */
-	for (i = 0; i < (int)num1; i++) {
-		if (cfg1[i].reg != cfg2[i].reg) {
-			same_order = 0;
-			break;
-		}
+
+	return 0;
+}
+
+/* ============================================================================
+ * Same-order value comparison
+ * ============================================================================
+ *
+ * When both tables list the same registers in the same order, entries differ
+ * exactly where their value columns differ, whatever the value width (32-bit
+ * DDRC or 16-bit PHY values). The columns are therefore compared as flat
+ * byte blocks, 32 bytes at a time with AVX2 (picked at run time), 16 with
+ * SSE2, and the few differing bytes are mapped back to entry numbers in a
+ * bitmask. Identical stretches cost one compare per block, so near-identical
+ * configurations are compared at memory bandwidth.
+ */
+
+/**
+ * @brief Mark the entries covering the differing bytes of one block
+ */
+static void mark_differing_bytes(uint64_t *mask, size_t off, uint32_t ne, size_t size) {
+	while (ne) {
+		set_bit(mask, (off + __builtin_ctz(ne)) / size);
+		ne &= ne - 1;
 	}
-	if (same_order) {
-		/* Same order - count value differences first */
-		for (i = 0; i < (int)num1; i++) {
-			if (cfg1[i].val != cfg2[i].val) {
-				diff_count++;
-			}
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+static size_t diff_blocks_avx2(const unsigned char *a, const unsigned char *b, size_t bytes,
+                               size_t size, uint64_t *mask) {
+	size_t off = 0;
+
+	for (; off + 32 <= bytes; off += 32) {
+		__m256i x = _mm256_loadu_si256((const __m256i *)(a + off));
+		__m256i y = _mm256_loadu_si256((const __m256i *)(b + off));
+		uint32_t ne = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y));
+		if (ne) {
+			mark_differing_bytes(mask, off, ne, size);
 		}
-		
-		/* Print summary before details */
-		if (diff_count > 0) {
-			print_info(indent, "Registers match, %d value differences", diff_count);
-			print_info(indent, "Register value differences:");
+	}
+
+	return off;
+}
+#endif
+
+/**
+ * @brief Compare num records of size bytes and flag the differing ones
+ *
+ * @param mask Output bitmap, BITMAP_WORDS(num) words
+ * @return Number of differing records
+ */
+static unsigned int diff_records(const void *cfg1, const void *cfg2, size_t num, size_t size,
+                                 uint64_t *mask) {
+	const unsigned char *a = cfg1, *b = cfg2;
+	size_t bytes = num * size;
+	size_t off = 0;
+	unsigned int count = 0;
+
+	memset(mask, 0, BITMAP_WORDS(num) * sizeof(*mask));
+
+#if defined(__x86_64__) || defined(__i386__)
+	if (__builtin_cpu_supports("avx2")) {
+		off = diff_blocks_avx2(a, b, bytes, size, mask);
+	}
+#endif
+#ifdef __SSE2__
+	for (; off + 16 <= bytes; off += 16) {
+		__m128i x = _mm_loadu_si128((const __m128i *)(a + off));
+		__m128i y = _mm_loadu_si128((const __m128i *)(b + off));
+		uint32_t ne = ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) & 0xffff;
+		if (ne) {
+			mark_differing_bytes(mask, off, ne, size);
 		}
-		
-		/* Now print the details */
-		for (i = 0; i < (int)num1; i++) {
-			if (cfg1[i].val != cfg2[i].val) {
-				printf("%s    " FMT_PHY_DIFF "\n", 
-				       indent, i, cfg1[i].reg, cfg1[i].val, cfg2[i].val);
-			}
+	}
+#endif
+	for (; off < bytes; off++) {
+		if (a[off] != b[off]) {
+			set_bit(mask, off / size);
 		}
-		
-		/* Return: 0 if all match, 1 if value differences */
-		if (diff_count_p) *diff_count_p = diff_count;
-		return 0;
-	} else {
-		/* Different order - check if all registers exist in both arrays */
-		int all_present = 1;
-		
-		/* Check if all registers from left exist in right */
-		for (i = 0; i < (int)num1; i++) {
-			int j, found = 0;
-			for (j = 0; j < (int)num2; j++) {
-				if (cfg1[i].reg == cfg2[j].reg) {
-					found = 1;
-					break;
-				}
+	}
+
+	for (size_t w = 0; w < BITMAP_WORDS(num); w++) {
+		count += __builtin_popcountll(mask[w]);
+	}
+
+	return count;
+}
+
+/**
+ * @brief Next flagged entry at or after i, num if none
+ */
+static unsigned int next_set_bit(const uint64_t *mask, unsigned int num, unsigned int i) {
+	while (i < num) {
+		uint64_t word = mask[i / 64] >> (i % 64);
+		if (word) {
+			i += __builtin_ctzll(word);
+			return i < num ? i : num;
+		}
+		i = (i / 64 + 1) * 64;
+	}
+	return num;
+}
+
+/**
+ * @brief Flag the leaf blocks whose CRCs differ between the trees of two equally long tables
+ *
+ * Called on the root; descends only into the nodes whose CRCs differ.
+ * @param changed Bitmap over the leaf blocks, cleared by the caller
+ */
+static void crc_tree_diff(const struct crc_tree *a, const struct crc_tree *b, unsigned int level,
+                          unsigned int k, uint64_t *changed) {
+	if (a->node[a->start[level] + k] == b->node[b->start[level] + k]) {
+		return;
+	}
+	if (level == 0) {
+		set_bit(changed, k);
+		return;
+	}
+
+	unsigned int first = k * CRC_BLOCK;
+	unsigned int last = first + CRC_BLOCK < a->count[level - 1] ? first + CRC_BLOCK : a->count[level - 1];
+	for (unsigned int c = first; c < last; c++) {
+		crc_tree_diff(a, b, level - 1, c, changed);
+	}
+}
+
+/* ============================================================================
+ * DDRC-specific helper functions
+ * ============================================================================ */
+
+/**
+ * @brief Print one reordered block of the DDRC reorder display
+ *
+ * cfg1[s1..s1+c1) is left-only and cfg2[s2..s2+c2) right-only at this point
+ * of the edit script; both are shown side-by-side when present.
+ */
+static void print_reorder_block_ddrc(const struct ddrc_table *cfg1, int s1, int c1,
+                                     const struct ddrc_table *cfg2, int s2, int c2,
+                                     const char *indent) {
+	if (c1 > 0 && c2 > 0) {
+		/* Both sides have blocks - they're relocated */
+		int max_show = (c1 < c2) ? c2 : c1;
+		if (max_show > 10) max_show = 10;
+		
+		for (int k = 0; k < max_show; k++) {
+			char left_buf[DDRC_COLUMN_WIDTH] = "";
+			char right_buf[DDRC_COLUMN_WIDTH] = "";
+			
+			if (k < c1) {
+				snprintf(left_buf, sizeof(left_buf), FMT_DDRC_ENTRY_4,
+				         s1 + k, cfg1->reg[s1 + k], cfg1->val[s1 + k]);
 			}
-			if (!found) {
-				if (all_present) {
-					print_error(indent, "Arrays have same length but different register sets!");
-					print_info(indent, "Registers in LEFT but not in RIGHT:");
-					all_present = 0;
-				}
-				printf("%s    " FMT_PHY_ENTRY "\n", indent, i, cfg1[i].reg, cfg1[i].val);
+			if (k < c2) {
+				snprintf(right_buf, sizeof(right_buf), FMT_DDRC_ENTRY_4,
+				         s2 + k, cfg2->reg[s2 + k], cfg2->val[s2 + k]);
 			}
+			
+			print_side_by_side(left_buf, right_buf, indent, 37);
 		}
 		
-		/* Check if all registers from right exist in left */
-		for (i = 0; i < (int)num2; i++) {
-			int j, found = 0;
-			for (j = 0; j < (int)num1; j++) {
-				if (cfg2[i].reg == cfg1[j].reg) {
-					found = 1;
-					break;
-				}
+		if (c1 > 10 || c2 > 10) {
+			char left_more[DDRC_COLUMN_WIDTH] = "";
+			char right_more[DDRC_COLUMN_WIDTH] = "";
+			if (c1 > 10) {
+				snprintf(left_more, sizeof(left_more), "... (%d more)", c1 - 10);
 			}
-			if (!found) {
-				if (all_present) {
-					print_error(indent, "Arrays have same length but different register sets!");
-					all_present = 0;
-				}
-				if (!all_present && i == 0) {
-					print_info(indent, "Registers in RIGHT but not in LEFT:");
-				}
-				printf("%s    " FMT_PHY_ENTRY "\n", indent, i, cfg2[i].reg, cfg2[i].val);
+			if (c2 > 10) {
+				snprintf(right_more, sizeof(right_more), "... (%d more)", c2 - 10);
 			}
+			print_side_by_side(left_more, right_more, indent, 37);
 		}
+	} else if (c1 > 0) {
+		/* Only left has block */
+		int show_count = (c1 < 10) ? c1 : 10;
 		
-		if (!all_present) {
-			/* Different register sets - structural error */
-			return -1;
+		for (int k = 0; k < show_count; k++) {
+			fprintf(out, "%s  " FMT_DDRC_ENTRY_4 "\n",
+			       indent, s1 + k, cfg1->reg[s1 + k], cfg1->val[s1 + k]);
 		}
-		
-		/* All registers present but different order - print warning first, then analyze with LCS-based diff */
-		print_warning(indent, "Registers match, different order");
-		print_reorder_header(indent);
-		
-		/* Use LCS (Longest Common Subsequence) approach to find matching blocks */
-		int i1 = 0, i2 = 0;
-		
-		while (i1 < (int)num1 && i2 < (int)num2) {
-			/* Check if registers at current positions match */
-			if (cfg1[i1].reg == cfg2[i2].reg) {
-				/* Found a matching block - scan forward to find the extent */
-				int start_i1 = i1;
-				int start_i2 = i2;
-				
-				while (i1 < (int)num1 && i2 < (int)num2 && cfg1[i1].reg == cfg2[i2].reg) {
-					i1++;
-					i2++;
-				}
-				
-#if SHOW_IDENTICAL_RANGES
-				/* Only show if more than a few registers to reduce noise */
-				if (i1 - start_i1 > 10) {
-					printf("%s  [%4d-%4d] (%d registers)           [%4d-%4d] (%d registers)\n",
-					       indent, start_i1, i1 - 1, i1 - start_i1, start_i2, i2 - 1, i2 - start_i2);
-				}
-#else
-				(void)start_i1; (void)start_i2; /* Unused when SHOW_IDENTICAL_RANGES is 0 */
-#endif
-			} else {
-				/* Registers don't match - find where blocks appear */
-				int block_start_i1 = i1;
-				
-				/* Scan forward in left to find extent of mismatched block */
-				while (i1 < (int)num1) {
-					/* Check if this register from left appears soon in right */
-					int found_soon = 0;
-					for (int check_j = i2; check_j < i2 + 50 && check_j < (int)num2; check_j++) {
-						if (cfg1[i1].reg == cfg2[check_j].reg) {
-							found_soon = 1;
-							break;
-						}
-					}
-					if (found_soon) break;
-					i1++;
-				}
-				
-				int block_start_i2 = i2;
-				
-				/* Scan forward in right to find extent of mismatched block */
-				while (i2 < (int)num2) {
-					/* Check if this register from right appears soon in left */
-					int found_soon = 0;
-					for (int check_i = i1; check_i < i1 + 50 && check_i < (int)num1; check_i++) {
-						if (cfg2[i2].reg == cfg1[check_i].reg) {
-							found_soon = 1;
-							break;
-						}
-					}
-					if (found_soon) break;
-					i2++;
-				}
-				
-				/* Display the relocated blocks side-by-side */
-				if (block_start_i1 < i1 && block_start_i2 < i2) {
-					/* Both sides have blocks - they're relocated */
-					int left_count = i1 - block_start_i1;
-					int right_count = i2 - block_start_i2;
-					int max_show = (left_count < right_count) ? right_count : left_count;
-					if (max_show > 10) max_show = 10;
-					
-					for (int k = 0; k < max_show; k++) {
-						char left_buf[PHY_COLUMN_WIDTH] = "";
-						char right_buf[PHY_COLUMN_WIDTH] = "";
-						
-						if (k < left_count) {
-							snprintf(left_buf, sizeof(left_buf), FMT_PHY_ENTRY_4,
-							         block_start_i1 + k, cfg1[block_start_i1 + k].reg, cfg1[block_start_i1 + k].val);
-						}
-						if (k < right_count) {
-							snprintf(right_buf, sizeof(right_buf), FMT_PHY_ENTRY_4,
-							         block_start_i2 + k, cfg2[block_start_i2 + k].reg, cfg2[block_start_i2 + k].val);
-						}
-						
-						print_side_by_side(left_buf, right_buf, indent, PHY_COLUMN_WIDTH);
-					}
-					
-					if (left_count > 10 || right_count > 10) {
-						char left_more[PHY_COLUMN_WIDTH] = "";
-						char right_more[PHY_COLUMN_WIDTH] = "";
-						if (left_count > 10) {
-							snprintf(left_more, sizeof(left_more), "... (%d more)", left_count - 10);
-						}
-						if (right_count > 10) {
-							snprintf(right_more, sizeof(right_more), "... (%d more)", right_count - 10);
-						}
-						print_side_by_side(left_more, right_more, indent, PHY_COLUMN_WIDTH);
-					}
-				} else if (block_start_i1 < i1) {
-					/* Only left has block */
-					int left_count = i1 - block_start_i1;
-					int show_count = (left_count < 10) ? left_count : 10;
-					
-					for (int k = 0; k < show_count; k++) {
-						char left_buf[PHY_COLUMN_WIDTH];
-						snprintf(left_buf, sizeof(left_buf), FMT_PHY_ENTRY_4,
-						         block_start_i1 + k, cfg1[block_start_i1 + k].reg, cfg1[block_start_i1 + k].val);
-						print_side_by_side(left_buf, "", indent, PHY_COLUMN_WIDTH);
-					}
-					if (left_count > 10) {
-						print_side_by_side("...", "", indent, PHY_COLUMN_WIDTH);
-						printf(" (%d more)\n", left_count - 10);
-					}
-				} else if (block_start_i2 < i2) {
-					/* Only right has block */
-					int right_count = i2 - block_start_i2;
-					int show_count = (right_count < 10) ? right_count : 10;
-					
-					for (int k = 0; k < show_count; k++) {
-						char right_buf[PHY_COLUMN_WIDTH];
-						snprintf(right_buf, sizeof(right_buf), FMT_PHY_ENTRY_4,
-						         block_start_i2 + k, cfg2[block_start_i2 + k].reg, cfg2[block_start_i2 + k].val);
-						print_side_by_side("", right_buf, indent, PHY_COLUMN_WIDTH);
-					}
-					if (right_count > 10) {
-						print_side_by_side("", "...", indent, PHY_COLUMN_WIDTH);
-						printf(" (%d more)\n", right_count - 10);
-					}
-				}
-			}
+		if (c1 > 10) {
+			fprintf(out, "%s  ... (%d more)\n", indent, c1 - 10);
 		}
+	} else if (c2 > 0) {
+		/* Only right has block */
+		int show_count = (c2 < 10) ? c2 : 10;
 		
-		/* Handle remaining registers at the end */
-		if (i1 < (int)num1) {
-			int remain_count = (int)num1 - i1;
-			int show_count = (remain_count < 10) ? remain_count : 10;
-			for (int k = 0; k < show_count; k++) {
-				char left_buf[PHY_COLUMN_WIDTH];
+		for (int k = 0; k < show_count; k++) {
+			char right_buf[DDRC_COLUMN_WIDTH];
+			snprintf(right_buf, sizeof(right_buf), FMT_DDRC_ENTRY_4,
+			         s2 + k, cfg2->reg[s2 + k], cfg2->val[s2 + k]);
+			print_side_by_side("", right_buf, indent, 37);
+		}
+		if (c2 > 10) {
+			char more_buf[DDRC_COLUMN_WIDTH];
+			snprintf(more_buf, sizeof(more_buf), "... (%d more)", c2 - 10);
+			print_side_by_side("", more_buf, indent, 37);
+		}
+	}
+}
+
+/* ============================================================================
+ * DDRPHY-specific helper functions
+ * ============================================================================ */
+
+/**
+ * @brief Print one reordered block of the DDRPHY reorder display
+ *
+ * cfg1[s1..s1+c1) is left-only and cfg2[s2..s2+c2) right-only at this point
+ * of the edit script; both are shown side-by-side when present.
+ */
+static void print_reorder_block_ddrphy(const struct phy_table *cfg1, int s1, int c1,
+                                       const struct phy_table *cfg2, int s2, int c2,
+                                       const char *indent) {
+	if (c1 > 0 && c2 > 0) {
+		/* Both sides have blocks - they're relocated */
+		int max_show = (c1 < c2) ? c2 : c1;
+		if (max_show > 10) max_show = 10;
+		
+		for (int k = 0; k < max_show; k++) {
+			char left_buf[PHY_COLUMN_WIDTH] = "";
+			char right_buf[PHY_COLUMN_WIDTH] = "";
+			
+			if (k < c1) {
 				snprintf(left_buf, sizeof(left_buf), FMT_PHY_ENTRY_4,
-				         i1 + k, cfg1[i1 + k].reg, cfg1[i1 + k].val);
-				print_side_by_side(left_buf, "", indent, PHY_COLUMN_WIDTH);
+				         s1 + k, cfg1->reg[s1 + k], cfg1->val[s1 + k]);
 			}
-			if (remain_count > 10) {
-				print_side_by_side("...", "", indent, PHY_COLUMN_WIDTH);
-				printf(" (%d more)\n", remain_count - 10);
-			}
-		}
-		if (i2 < (int)num2) {
-			int remain_count = (int)num2 - i2;
-			int show_count = (remain_count < 10) ? remain_count : 10;
-			for (int k = 0; k < show_count; k++) {
-				char right_buf[PHY_COLUMN_WIDTH];
+			if (k < c2) {
 				snprintf(right_buf, sizeof(right_buf), FMT_PHY_ENTRY_4,
-				         i2 + k, cfg2[i2 + k].reg, cfg2[i2 + k].val);
-				print_side_by_side("", right_buf, indent, PHY_COLUMN_WIDTH);
-			}
-			if (remain_count > 10) {
-				print_side_by_side("", "...", indent, PHY_COLUMN_WIDTH);
-				printf(" (%d more)\n", remain_count - 10);
+				         s2 + k, cfg2->reg[s2 + k], cfg2->val[s2 + k]);
 			}
+			
+			print_side_by_side(left_buf, right_buf, indent, PHY_COLUMN_WIDTH);
 		}
 		
-		/* Count value differences first */
-		for (i = 0; i < (int)num1; i++) {
-			/* Find matching register in cfg2 */
-			int j;
-			for (j = 0; j < (int)num2; j++) {
-				if (cfg1[i].reg == cfg2[j].reg) {
-					if (cfg1[i].val != cfg2[j].val) {
-						diff_count++;
-					}
-					break;
-				}
+		if (c1 > 10 || c2 > 10) {
+			char left_more[PHY_COLUMN_WIDTH] = "";
+			char right_more[PHY_COLUMN_WIDTH] = "";
+			if (c1 > 10) {
+				snprintf(left_more, sizeof(left_more), "... (%d more)", c1 - 10);
 			}
-		}
-		
-		/* Print summary and details for value differences */
-		if (diff_count > 0) {
-			print_info(indent, "Value differences: %d", diff_count);
-			print_info(indent, "Register value differences:");
-			/* Now print the details */
-			for (i = 0; i < (int)num1; i++) {
-				int j;
-				for (j = 0; j < (int)num2; j++) {
-					if (cfg1[i].reg == cfg2[j].reg) {
-						if (cfg1[i].val != cfg2[j].val) {
-							printf("%s    " FMT_PHY_DIFF_4 "\n", 
-							       indent, i, cfg1[i].reg, cfg1[i].val, cfg2[j].val);
-						}
-						break;
-					}
-				}
+			if (c2 > 10) {
+				snprintf(right_more, sizeof(right_more), "... (%d more)", c2 - 10);
 			}
+			print_side_by_side(left_more, right_more, indent, PHY_COLUMN_WIDTH);
 		}
+	} else if (c1 > 0) {
+		/* Only left has block */
+		int show_count = (c1 < 10) ? c1 : 10;
 		
-		/* Return: 2 for different order (diff_count tracks value differences) */
-		if (diff_count_p) *diff_count_p = diff_count;
+		for (int k = 0; k < show_count; k++) {
+			char left_buf[PHY_COLUMN_WIDTH];
+			snprintf(left_buf, sizeof(left_buf), FMT_PHY_ENTRY_4,
+			         s1 + k, cfg1->reg[s1 + k], cfg1->val[s1 + k]);
+			print_side_by_side(left_buf, "", indent, PHY_COLUMN_WIDTH);
+		}
+		if (c1 > 10) {
+			print_side_by_side("...", "", indent, PHY_COLUMN_WIDTH);
+			fprintf(out, " (%d more)\n", c1 - 10);
+		}
+	} else if (c2 > 0) {
+		/* Only right has block */
+		int show_count = (c2 < 10) ? c2 : 10;
 		
-		return 1;
+		for (int k = 0; k < show_count; k++) {
+			char right_buf[PHY_COLUMN_WIDTH];
+			snprintf(right_buf, sizeof(right_buf), FMT_PHY_ENTRY_4,
+			         s2 + k, cfg2->reg[s2 + k], cfg2->val[s2 + k]);
+			print_side_by_side("", right_buf, indent, PHY_COLUMN_WIDTH);
+		}
+		if (c2 > 10) {
+			print_side_by_side("", "...", indent, PHY_COLUMN_WIDTH);
+			fprintf(out, " (%d more)\n", c2 - 10);
+		}
+	}
+}
+
+/**
+ * @brief Print consolidated summary based on comparison return value
+ * 
+ * This function interprets the standardized return values from comparison functions
+ * and prints appropriate summary messages.
+ * 
+ * Return value scheme:
+ *   -1: Different size or different register sets (structural error)
+ *    0: Identical registers, same order (diff_count indicates value differences)
+ *    1: Identical registers, different order (diff_count indicates value differences)
+ * 
+ * @param result Return value from comparison function (-1, 0, 1)
+ * @param diff_count Number of value differences
+ * @param indent Indentation string for formatting output
+ */
+static void print_comparison_summary(int result, int diff_count, const char *indent) {
+	switch (result) {
+		case -1:
+			/* Different size or register sets - error already printed */
+			/* Structural differences message now printed earlier, at the point of detection */
+			break;
+		case 0:
+			/* Same order */
+			if (diff_count == 0) {
+				print_success(indent, "Registers and values match");
+			}
+			/* Warning for value differences already printed inside comparison function */
+			break;
+		case 1:
+			/* Different order - warning already printed inside comparison function */
+			break;
+		default:
+			print_error(indent, "Unexpected comparison result %d", result);
+			break;
+	}
+}
+
+/* A register that occurs more than once in a table */
+struct duplicate_info {
+	unsigned int reg;
+	unsigned int first;            /* where its positions start in the pool of its set */
+	unsigned int count;
+};
+
+/*
+ * All duplicate registers of a table, in order of first occurrence. The
+ * groups and their ascending positions share one block from the scratch
+ * arena, so a set lasts until its section's scratch_reset() and each
+ * check keeps its own sets on the stack.
+ */
+struct duplicate_set {
+	struct duplicate_info *groups;
+	unsigned int *pool;            /* positions of all groups, back to back */
+	unsigned int num_groups;
+};
+
+/**
+ * @brief Empty a set and make room for num_groups groups holding total positions
+ *
+ * The room is taken from the scratch arena and released by scratch_reset().
+ *
+ * @return 0 on success, -1 if out of memory (the set is left empty)
+ */
+static int duplicate_set_reserve(struct duplicate_set *set, unsigned int num_groups, unsigned int total) {
+	void *buf = NULL;
+
+	if (num_groups || total) {
+		buf = scratch_alloc(num_groups * sizeof(*set->groups) + total * sizeof(*set->pool));
 	}
+	set->groups = buf;
+	set->pool = buf ? (unsigned int *)(set->groups + num_groups) : NULL;
+	set->num_groups = 0;
+
+	return ((num_groups || total) && !buf) ? -1 : 0;
 }
 
+/* ============================================================================
+ * Comparison engine
+ * ============================================================================
+ *
+ * The comparison, reorder, unique register and duplicate logic lives once
+ * in compare_engine.h and is instantiated here for each table type, with
+ * its formats, widths and register index fixed at compile time.
+ */
+
+#define ENGINE_TYPE             ddrc
+#define ENGINE_TABLE            struct ddrc_table
+#define ENGINE_TABLE_ALLOC      ddrc_table_alloc
+#define ENGINE_TABLE_CRC        ddrc_table_crc
+#define ENGINE_COMMON1          ddrc1
+#define ENGINE_COMMON2          ddrc2
+#define ENGINE_INDEX            reg_index
+#define ENGINE_ENTRY_SIZE       (unsigned int)sizeof(struct ddrc_cfg_param)
+#define ENGINE_FMT_REG          FMT_DDRC_REG
+#define ENGINE_FMT_VAL          FMT_DDRC_VAL
+#define ENGINE_FMT_ENTRY        FMT_DDRC_ENTRY
+#define ENGINE_FMT_ENTRY_4      FMT_DDRC_ENTRY_4
+#define ENGINE_FMT_DIFF         FMT_DDRC_DIFF
+#define ENGINE_FMT_DIFF_4       FMT_DDRC_DIFF_4
+#define ENGINE_FMT_UNIQUE_RIGHT FMT_PHY_ENTRY    /* as the DDRC report has always shown them */
+#define ENGINE_COLUMN_WIDTH     DDRC_COLUMN_WIDTH
+#include "compare_engine.h"
+
+#define ENGINE_TYPE             ddrphy
+#define ENGINE_TABLE            struct phy_table
+#define ENGINE_TABLE_ALLOC      phy_table_alloc
+#define ENGINE_TABLE_CRC        phy_table_crc
+#define ENGINE_COMMON1          phy1
+#define ENGINE_COMMON2          phy2
+#define ENGINE_INDEX            phy_index
+#define ENGINE_ENTRY_SIZE       (unsigned int)sizeof(struct ddrphy_cfg_param)
+#define ENGINE_FMT_REG          FMT_PHY_REG
+#define ENGINE_FMT_VAL          FMT_PHY_VAL
+#define ENGINE_FMT_ENTRY        FMT_PHY_ENTRY
+#define ENGINE_FMT_ENTRY_4      FMT_PHY_ENTRY_4
+#define ENGINE_FMT_DIFF         FMT_PHY_DIFF
+#define ENGINE_FMT_DIFF_4       FMT_PHY_DIFF_4
+#define ENGINE_FMT_UNIQUE_RIGHT FMT_PHY_ENTRY
+#define ENGINE_COLUMN_WIDTH     PHY_COLUMN_WIDTH
+#include "compare_engine.h"
+
 /**
  * @brief Compare ddrc_cfg structures between left and right configurations
  * 
@@ -1642,39 +1803,31 @@ static int check_ddrc_cfg(void) {
 	int result;
 	int diff_count = 0;
 	
-	printf("┌─────────────────────────────────────────────────────────────────────────┐\n");
-	printf("│ Checking ddrc_cfg                                                       │\n");
-	printf("└─────────────────────────────────────────────────────────────────────────┘\n");
+	fprintf(out, "┌─────────────────────────────────────────────────────────────────────────┐\n");
+	fprintf(out, "│ Checking ddrc_cfg                                                       │\n");
+	fprintf(out, "└─────────────────────────────────────────────────────────────────────────┘\n");
 	
-	result = compare_ddrc_cfg_arrays(dram_timing_left.ddrc_cfg, dram_timing_left.ddrc_cfg_num,
-	                                  dram_timing_right.ddrc_cfg, dram_timing_right.ddrc_cfg_num,
+	result = compare_ddrc_cfg_arrays(&tables_left.ddrc_cfg, &tables_right.ddrc_cfg,
 	                                  "  ", &diff_count, 1);
 	
 	print_comparison_summary(result, diff_count, "  ");
 	
 	/* Check duplicates after comparison summary */
-	struct duplicate_info left_dups[100];
-	struct duplicate_info right_dups[100];
-	int left_dup_count = find_duplicates_ddrc(dram_timing_left.ddrc_cfg, dram_timing_left.ddrc_cfg_num,
-	                                           left_dups, 100);
-	int right_dup_count = find_duplicates_ddrc(dram_timing_right.ddrc_cfg, dram_timing_right.ddrc_cfg_num,
-	                                            right_dups, 100);
+	struct duplicate_set dups_left, dups_right;
+	int left_dup_count = find_duplicates_ddrc(&tables_left.ddrc_cfg, &dups_left);
+	int right_dup_count = find_duplicates_ddrc(&tables_right.ddrc_cfg, &dups_right);
 	
 	if (left_dup_count > 0 || right_dup_count > 0) {
-		/* Check for interference between duplicates and value differences */
-		if (result >= 0 && diff_count > 0) {
-			/* Only check if same size and there are value differences */
-			if (dram_timing_left.ddrc_cfg_num == dram_timing_right.ddrc_cfg_num) {
-				check_duplicate_interference(dram_timing_left.ddrc_cfg, dram_timing_right.ddrc_cfg,
-				                           dram_timing_left.ddrc_cfg_num, 
-				                           left_dups, left_dup_count, 
-				                           right_dups, right_dup_count, "  ", 1);
-			}
+		/* Check for interference between duplicates and value differences,
+		 * over the common registers when the lengths differ */
+		if (diff_count > 0) {
+			check_duplicate_interference_ddrc(&tables_left.ddrc_cfg, &tables_right.ddrc_cfg,
+			                                  &dups_left, &dups_right, "  ");
 		}
 		
 		if (opt_list_duplicates) {
 			/* Show detailed list */
-			print_duplicates_ddrc_sidebyside(left_dups, left_dup_count, right_dups, right_dup_count, "  ");
+			print_duplicates_ddrc_sidebyside(&dups_left, &dups_right, "  ");
 		} else {
 			/* Show summary only */
 			int total = left_dup_count + right_dup_count;
@@ -1682,7 +1835,7 @@ static int check_ddrc_cfg(void) {
 		}
 	}
 	
-	printf("\n");
+	fprintf(out, "\n");
 	
 	return 0;  /* Always return success - differences are informational */
 }
@@ -1697,15 +1850,15 @@ static int check_fsp_cfg(void) {
 	int ret = 0;
 	int total_diff_count = 0;
 	
-	printf("┌─────────────────────────────────────────────────────────────────────────┐\n");
-	printf("│ Checking fsp_cfg                                                        │\n");
-	printf("└─────────────────────────────────────────────────────────────────────────┘\n");
-	printf("  FSP Entries: Left=%u, Right=%u\n", 
+	fprintf(out, "┌─────────────────────────────────────────────────────────────────────────┐\n");
+	fprintf(out, "│ Checking fsp_cfg                                                        │\n");
+	fprintf(out, "└─────────────────────────────────────────────────────────────────────────┘\n");
+	fprintf(out, "  FSP Entries: Left=%u, Right=%u\n", 
 	       dram_timing_left.fsp_cfg_num, dram_timing_right.fsp_cfg_num);
 	
 	if (dram_timing_left.fsp_cfg_num != dram_timing_right.fsp_cfg_num) {
 		print_error("  ", "Number of FSP entries do not match!");
-		printf("\n");
+		fprintf(out, "\n");
 		return -1;
 	}
 	
@@ -1713,11 +1866,10 @@ static int check_fsp_cfg(void) {
 		int fsp_result;
 		int fsp_diff_count = 0;
 		
-		printf("\n  FSP %d:\n", i);
-		printf("  ┌─── ddrc_cfg ─────────────────────────────────────────────────────┐\n");
+		fprintf(out, "\n  FSP %d:\n", i);
+		fprintf(out, "  ┌─── ddrc_cfg ─────────────────────────────────────────────────────┐\n");
 		fsp_result = compare_ddrc_cfg_arrays(
-			dram_timing_left.fsp_cfg[i].ddrc_cfg, dram_timing_left.fsp_cfg[i].ddrc_cfg_num,
-			dram_timing_right.fsp_cfg[i].ddrc_cfg, dram_timing_right.fsp_cfg[i].ddrc_cfg_num,
+			&tables_left.fsp_ddrc_cfg[i], &tables_right.fsp_ddrc_cfg[i],
 			"    ", &fsp_diff_count, 1);
 		
 		if (fsp_result < 0) {
@@ -1726,18 +1878,18 @@ static int check_fsp_cfg(void) {
 		
 		/* Check bypass */
 		if (dram_timing_left.fsp_cfg[i].bypass != dram_timing_right.fsp_cfg[i].bypass) {
-			printf("    bypass: %u → %u\n",
+			fprintf(out, "    bypass: %u → %u\n",
 			       dram_timing_left.fsp_cfg[i].bypass,
 			       dram_timing_right.fsp_cfg[i].bypass);
 			fsp_diff_count++;
 		}
 		
-		printf("  └──────────────────────────────────────────────────────────────────┘\n");
+		fprintf(out, "  └──────────────────────────────────────────────────────────────────┘\n");
 		
 		total_diff_count += fsp_diff_count;
 	}
 	
-	printf("\n");
+	fprintf(out, "\n");
 	
 	return ret;
 }
@@ -1751,16 +1903,15 @@ static int check_ddrphy_cfg(void) {
 	int result;
 	int diff_count = 0;
 	
-	printf("┌─────────────────────────────────────────────────────────────────────────┐\n");
-	printf("│ Checking ddrphy_cfg                                                     │\n");
-	printf("└─────────────────────────────────────────────────────────────────────────┘\n");
+	fprintf(out, "┌─────────────────────────────────────────────────────────────────────────┐\n");
+	fprintf(out, "│ Checking ddrphy_cfg                                                     │\n");
+	fprintf(out, "└─────────────────────────────────────────────────────────────────────────┘\n");
 	
-	result = compare_ddrphy_cfg_arrays(dram_timing_left.ddrphy_cfg, dram_timing_left.ddrphy_cfg_num,
-	                                    dram_timing_right.ddrphy_cfg, dram_timing_right.ddrphy_cfg_num,
+	result = compare_ddrphy_cfg_arrays(&tables_left.ddrphy_cfg, &tables_right.ddrphy_cfg,
 	                                    "  ", &diff_count, 1);
 	
 	print_comparison_summary(result, diff_count, "  ");
-	printf("\n");
+	fprintf(out, "\n");
 	
 	return 0;  /* Always return success - differences are informational */
 }
@@ -1775,15 +1926,15 @@ static int check_fsp_msg(void) {
 	int ret = 0;
 	int total_diff_count = 0;
 	
-	printf("┌─────────────────────────────────────────────────────────────────────────┐\n");
-	printf("│ Checking fsp_msg                                                        │\n");
-	printf("└─────────────────────────────────────────────────────────────────────────┘\n");
-	printf("  FSP Message Entries: Left=%u, Right=%u\n", 
+	fprintf(out, "┌─────────────────────────────────────────────────────────────────────────┐\n");
+	fprintf(out, "│ Checking fsp_msg                                                        │\n");
+	fprintf(out, "└─────────────────────────────────────────────────────────────────────────┘\n");
+	fprintf(out, "  FSP Message Entries: Left=%u, Right=%u\n", 
 	       dram_timing_left.fsp_msg_num, dram_timing_right.fsp_msg_num);
 	
 	if (dram_timing_left.fsp_msg_num != dram_timing_right.fsp_msg_num) {
 		print_error("  ", "Number of FSP message entries do not match!");
-		printf("\n");
+		fprintf(out, "\n");
 		return -1;
 	}
 	
@@ -1791,11 +1942,11 @@ static int check_fsp_msg(void) {
 		int result;
 		int diff_count;
 		
-		printf("\n  FSP Message %d:\n", i);
+		fprintf(out, "\n  FSP Message %d:\n", i);
 		
 		/* Check drate */
 		if (dram_timing_left.fsp_msg[i].drate != dram_timing_right.fsp_msg[i].drate) {
-			printf("    drate: %u → %u\n",
+			fprintf(out, "    drate: %u → %u\n",
 			       dram_timing_left.fsp_msg[i].drate,
 			       dram_timing_right.fsp_msg[i].drate);
 			total_diff_count++;
@@ -1803,19 +1954,18 @@ static int check_fsp_msg(void) {
 		
 		/* Check fw_type */
 		if (dram_timing_left.fsp_msg[i].fw_type != dram_timing_right.fsp_msg[i].fw_type) {
-			printf("    fw_type: %d → %d\n",
+			fprintf(out, "    fw_type: %d → %d\n",
 			       dram_timing_left.fsp_msg[i].fw_type,
 			       dram_timing_right.fsp_msg[i].fw_type);
 			total_diff_count++;
 		}
 		
 		/* Check fsp_phy_cfg */
-		printf("\n");
-		printf("    ┌─── fsp_phy_cfg ──────────────────────────────────────────────┐\n");
+		fprintf(out, "\n");
+		fprintf(out, "    ┌─── fsp_phy_cfg ──────────────────────────────────────────────┐\n");
 		
 		result = compare_ddrphy_cfg_arrays(
-			dram_timing_left.fsp_msg[i].fsp_phy_cfg, dram_timing_left.fsp_msg[i].fsp_phy_cfg_num,
-			dram_timing_right.fsp_msg[i].fsp_phy_cfg, dram_timing_right.fsp_msg[i].fsp_phy_cfg_num,
+			&tables_left.fsp_phy_cfg[i], &tables_right.fsp_phy_cfg[i],
 			"      ", &diff_count, 1);
 		
 		if (result < 0) {
@@ -1823,15 +1973,14 @@ static int check_fsp_msg(void) {
 		}
 		total_diff_count += diff_count;
 		print_comparison_summary(result, diff_count, "      ");
-		printf("    └──────────────────────────────────────────────────────────────┘\n");
+		fprintf(out, "    └──────────────────────────────────────────────────────────────┘\n");
 		
 		/* Check fsp_phy_msgh_cfg */
-		printf("\n");
-		printf("    ┌─── fsp_phy_msgh_cfg ─────────────────────────────────────────┐\n");
+		fprintf(out, "\n");
+		fprintf(out, "    ┌─── fsp_phy_msgh_cfg ─────────────────────────────────────────┐\n");
 		
 		result = compare_ddrphy_cfg_arrays(
-			dram_timing_left.fsp_msg[i].fsp_phy_msgh_cfg, dram_timing_left.fsp_msg[i].fsp_phy_msgh_cfg_num,
-			dram_timing_right.fsp_msg[i].fsp_phy_msgh_cfg, dram_timing_right.fsp_msg[i].fsp_phy_msgh_cfg_num,
+			&tables_left.fsp_phy_msgh_cfg[i], &tables_right.fsp_phy_msgh_cfg[i],
 			"      ", &diff_count, 1);
 		
 		if (result < 0) {
@@ -1839,15 +1988,14 @@ static int check_fsp_msg(void) {
 		}
 		total_diff_count += diff_count;
 		print_comparison_summary(result, diff_count, "      ");
-		printf("    └──────────────────────────────────────────────────────────────┘\n");
+		fprintf(out, "    └──────────────────────────────────────────────────────────────┘\n");
 		
 		/* Check fsp_phy_pie_cfg */
-		printf("\n");
-		printf("    ┌─── fsp_phy_pie_cfg ──────────────────────────────────────────┐\n");
+		fprintf(out, "\n");
+		fprintf(out, "    ┌─── fsp_phy_pie_cfg ──────────────────────────────────────────┐\n");
 		
 		result = compare_ddrphy_cfg_arrays(
-			dram_timing_left.fsp_msg[i].fsp_phy_pie_cfg, dram_timing_left.fsp_msg[i].fsp_phy_pie_cfg_num,
-			dram_timing_right.fsp_msg[i].fsp_phy_pie_cfg, dram_timing_right.fsp_msg[i].fsp_phy_pie_cfg_num,
+			&tables_left.fsp_phy_pie_cfg[i], &tables_right.fsp_phy_pie_cfg[i],
 			"      ", &diff_count, 1);
 		
 		if (result < 0) {
@@ -1855,13 +2003,13 @@ static int check_fsp_msg(void) {
 		}
 		total_diff_count += diff_count;
 		print_comparison_summary(result, diff_count, "      ");
-		printf("    └──────────────────────────────────────────────────────────────┘\n");
+		fprintf(out, "    └──────────────────────────────────────────────────────────────┘\n");
 	}
 	
 	if (ret != 0) {
 		print_warning("\n  ", "Structural errors found");
 	}
-	printf("\n");
+	fprintf(out, "\n");
 	
 	return ret;
 }
@@ -1875,16 +2023,15 @@ static int check_ddrphy_trained_csr(void) {
 	int result;
 	int diff_count = 0;
 	
-	printf("┌─────────────────────────────────────────────────────────────────────────┐\n");
-	printf("│ Checking ddrphy_trained_csr                                             │\n");
-	printf("└─────────────────────────────────────────────────────────────────────────┘\n");
+	fprintf(out, "┌─────────────────────────────────────────────────────────────────────────┐\n");
+	fprintf(out, "│ Checking ddrphy_trained_csr                                             │\n");
+	fprintf(out, "└─────────────────────────────────────────────────────────────────────────┘\n");
 	
-	result = compare_ddrphy_cfg_arrays(dram_timing_left.ddrphy_trained_csr, dram_timing_left.ddrphy_trained_csr_num,
-	                                    dram_timing_right.ddrphy_trained_csr, dram_timing_right.ddrphy_trained_csr_num,
+	result = compare_ddrphy_cfg_arrays(&tables_left.trained_csr, &tables_right.trained_csr,
 	                                    "  ", &diff_count, 1);
 	
 	print_comparison_summary(result, diff_count, "  ");
-	printf("\n");
+	fprintf(out, "\n");
 	
 	return 0;  /* Always return success - differences are informational */
 }
@@ -1898,39 +2045,31 @@ static int check_ddrphy_pie(void) {
 	int result;
 	int diff_count = 0;
 	
-	printf("┌─────────────────────────────────────────────────────────────────────────┐\n");
-	printf("│ Checking ddrphy_pie                                                     │\n");
-	printf("└─────────────────────────────────────────────────────────────────────────┘\n");
+	fprintf(out, "┌─────────────────────────────────────────────────────────────────────────┐\n");
+	fprintf(out, "│ Checking ddrphy_pie                                                     │\n");
+	fprintf(out, "└─────────────────────────────────────────────────────────────────────────┘\n");
 	
-	result = compare_ddrphy_cfg_arrays(dram_timing_left.ddrphy_pie, dram_timing_left.ddrphy_pie_num,
-	                                    dram_timing_right.ddrphy_pie, dram_timing_right.ddrphy_pie_num,
+	result = compare_ddrphy_cfg_arrays(&tables_left.pie, &tables_right.pie,
 	                                    "  ", &diff_count, 1);
 	
 	print_comparison_summary(result, diff_count, "  ");
 	
 	/* Check duplicates after comparison summary */
-	struct duplicate_info left_dups[100];
-	struct duplicate_info right_dups[100];
-	int left_dup_count = find_duplicates_ddrphy(dram_timing_left.ddrphy_pie, dram_timing_left.ddrphy_pie_num,
-	                                             left_dups, 100);
-	int right_dup_count = find_duplicates_ddrphy(dram_timing_right.ddrphy_pie, dram_timing_right.ddrphy_pie_num,
-	                                              right_dups, 100);
+	struct duplicate_set dups_left, dups_right;
+	int left_dup_count = find_duplicates_ddrphy(&tables_left.pie, &dups_left);
+	int right_dup_count = find_duplicates_ddrphy(&tables_right.pie, &dups_right);
 	
 	if (left_dup_count > 0 || right_dup_count > 0) {
-		/* Check for interference between duplicates and value differences */
-		if (result >= 0 && diff_count > 0) {
-			/* Only check if same size and there are value differences */
-			if (dram_timing_left.ddrphy_pie_num == dram_timing_right.ddrphy_pie_num) {
-				check_duplicate_interference(dram_timing_left.ddrphy_pie, dram_timing_right.ddrphy_pie,
-				                           dram_timing_left.ddrphy_pie_num, 
-				                           left_dups, left_dup_count, 
-				                           right_dups, right_dup_count, "  ", 0);
-			}
+		/* Check for interference between duplicates and value differences,
+		 * over the common registers when the lengths differ */
+		if (diff_count > 0) {
+			check_duplicate_interference_ddrphy(&tables_left.pie, &tables_right.pie,
+			                                    &dups_left, &dups_right, "  ");
 		}
 		
 		if (opt_list_duplicates) {
 			/* Show detailed list */
-			print_duplicates_ddrphy_sidebyside(left_dups, left_dup_count, right_dups, right_dup_count, "  ");
+			print_duplicates_ddrphy_sidebyside(&dups_left, &dups_right, "  ");
 		} else {
 			/* Show summary only */
 			int total = left_dup_count + right_dup_count;
@@ -1938,51 +2077,577 @@ static int check_ddrphy_pie(void) {
 		}
 	}
 	
-	printf("\n");
+	fprintf(out, "\n");
 	
 	return 0;  /* Always return success - differences are informational */
 }
 
-int main(int argc, char *argv[]) {
+/* ============================================================================
+ * Readback check
+ * ============================================================================
+ *
+ * Diffs a live register readback log (see ddrconf_read_readback()) against
+ * the expected values of one configuration. The expected value of every
+ * register is its last write in the order the firmware programs the
+ * tables: ddrc_cfg, fsp_cfg[].ddrc_cfg, ddrphy_cfg, fsp_msg[].fsp_phy_cfg,
+ * fsp_msg[].fsp_phy_pie_cfg and ddrphy_pie. Message block and trained CSR
+ * tables are left out, as training overwrites them.
+ *
+ * The expected registers are indexed by bus address in an open addressing
+ * hash table, so each read in the log is checked in constant time and only
+ * per-register counters are kept, whatever the length of the log. PHY
+ * registers are addressed as base + 4 * reg with --phy-base, or by their
+ * 20-bit register number otherwise.
+ */
+
+struct readback_reg {
+	unsigned int addr;          /* bus address */
+	unsigned int reg;           /* register as listed in the configuration */
+	unsigned int val;           /* expected value */
+	unsigned int mask;          /* bits read back that are compared */
+	const char *table;          /* table holding the last write */
+	unsigned long reads;
+	unsigned long mismatches;
+	unsigned long first_line;   /* line of the first mismatch */
+	unsigned int first_val;     /* value of the first mismatch */
+	unsigned int last_val;      /* value of the last mismatch */
+};
+
+struct readback_index {
+	struct readback_reg *regs;  /* in configuration order */
+	unsigned int num;
+	unsigned int *slots;        /* 1-based indices into regs, 0 if empty */
+	unsigned int slot_mask;
+	unsigned long reads;
+	unsigned long unknown;      /* reads of addresses not in the configuration */
+};
+
+/* PHY base address for --phy-base, and whether one was given */
+static unsigned int opt_phy_base;
+static int opt_have_phy_base = 0;
+
+static unsigned int readback_slot(const struct readback_index *index, unsigned int addr) {
+	return (addr * 0x9e3779b1u) & index->slot_mask;
+}
+
+static struct readback_reg *readback_find(const struct readback_index *index, unsigned int addr) {
+	unsigned int slot = readback_slot(index, addr);
+
+	while (index->slots[slot]) {
+		struct readback_reg *r = &index->regs[index->slots[slot] - 1];
+		if (r->addr == addr) {
+			return r;
+		}
+		slot = (slot + 1) & index->slot_mask;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Record the expected value of one register (later writes win)
+ */
+static void readback_add(struct readback_index *index, unsigned int addr, unsigned int reg,
+                         unsigned int val, unsigned int mask, const char *table) {
+	unsigned int slot = readback_slot(index, addr);
+	struct readback_reg *r;
+
+	while (index->slots[slot]) {
+		r = &index->regs[index->slots[slot] - 1];
+		if (r->addr == addr) {
+			r->val = val & mask;
+			r->table = table;
+			return;
+		}
+		slot = (slot + 1) & index->slot_mask;
+	}
+
+	r = &index->regs[index->num++];
+	memset(r, 0, sizeof(*r));
+	r->addr = addr;
+	r->reg = reg;
+	r->val = val & mask;
+	r->mask = mask;
+	r->table = table;
+	index->slots[slot] = index->num;
+}
+
+static void readback_add_ddrc(struct readback_index *index, const struct ddrc_cfg_param *cfg,
+                              unsigned int num, const char *table) {
+	for (unsigned int i = 0; i < num; i++) {
+		readback_add(index, cfg[i].reg, cfg[i].reg, cfg[i].val, 0xffffffff, table);
+	}
+}
+
+static void readback_add_ddrphy(struct readback_index *index, const struct ddrphy_cfg_param *cfg,
+                                unsigned int num, const char *table) {
+	for (unsigned int i = 0; i < num; i++) {
+		unsigned int addr = opt_have_phy_base ? opt_phy_base + cfg[i].reg * 4 : cfg[i].reg;
+		readback_add(index, addr, cfg[i].reg, cfg[i].val, 0xffff, table);
+	}
+}
+
+/**
+ * @brief Build the address index of the expected register values
+ *
+ * @return 0 on success, -1 if out of memory
+ */
+static int readback_build(struct readback_index *index, const struct dram_timing_info *t) {
+	unsigned long total = t->ddrc_cfg_num + t->ddrphy_cfg_num + t->ddrphy_pie_num;
+	unsigned int size = 16;
+
+	for (unsigned int i = 0; i < t->fsp_cfg_num; i++) {
+		total += t->fsp_cfg[i].ddrc_cfg_num;
+	}
+	for (unsigned int i = 0; i < t->fsp_msg_num; i++) {
+		total += t->fsp_msg[i].fsp_phy_cfg_num + t->fsp_msg[i].fsp_phy_pie_cfg_num;
+	}
+
+	/* Keep the table at most half full */
+	while (size < 2 * total) {
+		size *= 2;
+	}
+
+	memset(index, 0, sizeof(*index));
+	index->regs = malloc(total * sizeof(*index->regs) + 1);
+	index->slots = calloc(size, sizeof(*index->slots));
+	if (!index->regs || !index->slots) {
+		free(index->regs);
+		free(index->slots);
+		return -1;
+	}
+	index->slot_mask = size - 1;
+
+	readback_add_ddrc(index, t->ddrc_cfg, t->ddrc_cfg_num, "ddrc_cfg");
+	for (unsigned int i = 0; i < t->fsp_cfg_num; i++) {
+		readback_add_ddrc(index, t->fsp_cfg[i].ddrc_cfg, t->fsp_cfg[i].ddrc_cfg_num, "fsp_cfg.ddrc_cfg");
+	}
+	readback_add_ddrphy(index, t->ddrphy_cfg, t->ddrphy_cfg_num, "ddrphy_cfg");
+	for (unsigned int i = 0; i < t->fsp_msg_num; i++) {
+		readback_add_ddrphy(index, t->fsp_msg[i].fsp_phy_cfg, t->fsp_msg[i].fsp_phy_cfg_num,
+		                    "fsp_msg.fsp_phy_cfg");
+	}
+	for (unsigned int i = 0; i < t->fsp_msg_num; i++) {
+		readback_add_ddrphy(index, t->fsp_msg[i].fsp_phy_pie_cfg, t->fsp_msg[i].fsp_phy_pie_cfg_num,
+		                    "fsp_msg.fsp_phy_pie_cfg");
+	}
+	readback_add_ddrphy(index, t->ddrphy_pie, t->ddrphy_pie_num, "ddrphy_pie");
+
+	return 0;
+}
+
+/**
+ * @brief Account one read from the log
+ */
+static int readback_read(void *ctx, unsigned int addr, unsigned int val, unsigned long line) {
+	struct readback_index *index = ctx;
+	struct readback_reg *r = readback_find(index, addr);
+
+	index->reads++;
+	if (!r) {
+		index->unknown++;
+		return 0;
+	}
+
+	r->reads++;
+	val &= r->mask;
+	if (val != r->val) {
+		if (!r->mismatches) {
+			r->first_line = line;
+			r->first_val = val;
+		}
+		r->mismatches++;
+		r->last_val = val;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Diff a readback log against the configuration in dram_timing_left
+ *
+ * @param path Readback log, "-" for standard input
+ * @return 0 if every read matched, 1 on mismatches, -1 on error
+ */
+static int check_readback(const char *path) {
+	struct readback_index index;
+	unsigned int mismatched = 0, unread = 0;
+	int ret;
+
+	fprintf(out, "┌─────────────────────────────────────────────────────────────────────────┐\n");
+	fprintf(out, "│ Checking readback                                                       │\n");
+	fprintf(out, "└─────────────────────────────────────────────────────────────────────────┘\n");
+
+	if (readback_build(&index, &dram_timing_left) != 0) {
+		fprintf(stderr, "Out of memory\n");
+		return -1;
+	}
+
+	ret = ddrconf_read_readback(path, readback_read, &index);
+	if (ret != 0) {
+		free(index.regs);
+		free(index.slots);
+		return -1;
+	}
+
+	for (unsigned int i = 0; i < index.num; i++) {
+		const struct readback_reg *r = &index.regs[i];
+		int width = r->mask == 0xffff ? 4 : 8;
+
+		if (!r->reads) {
+			unread++;
+			continue;
+		}
+		if (!r->mismatches) {
+			continue;
+		}
+
+		mismatched++;
+		if (r->last_val != r->first_val) {
+			print_warning("  ", "%s 0x%x: expected 0x%0*x, read 0x%0*x ... 0x%0*x "
+			              "(%lu of %lu reads differ, first at line %lu)",
+			              r->table, r->reg, width, r->val, width, r->first_val, width, r->last_val,
+			              r->mismatches, r->reads, r->first_line);
+		} else {
+			print_warning("  ", "%s 0x%x: expected 0x%0*x, read 0x%0*x "
+			              "(%lu of %lu reads differ, first at line %lu)",
+			              r->table, r->reg, width, r->val, width, r->first_val,
+			              r->mismatches, r->reads, r->first_line);
+		}
+	}
+
+	print_info("  ", "%lu reads, %u of %u registers read back, %lu reads of unlisted addresses",
+	           index.reads, index.num - unread, index.num, index.unknown);
+	if (mismatched) {
+		print_error("  ", "%u registers differ from the configuration", mismatched);
+	} else if (index.num - unread) {
+		print_success("  ", "All registers read back match");
+	}
+	fprintf(out, "\n");
+
+	free(index.regs);
+	free(index.slots);
+
+	return mismatched ? 1 : 0;
+}
+
+/*
+ * Comparison pipeline
+ *
+ * Load stage:    both configurations are loaded concurrently and converted
+ *                to their working tables.
+ * Compare stage: each section below is compared on a worker thread and
+ *                rendered into its own memory buffer.
+ * Output stage:  the main thread writes finished sections in order and
+ *                flushes after each one.
+ *
+ * The compare stage runs at most REPORT_QUEUE_DEPTH sections ahead of the
+ * output stage, so a slow terminal or pipe bounds the buffered output and
+ * the first section is on screen while the large PHY tables are compared.
+ */
+#define REPORT_QUEUE_DEPTH 2
+
+static int (*const check_sections[])(void) = {
+	/** DDRC configurations */
+	check_ddrc_cfg,
+	check_fsp_cfg,
+	/** DDR PHY configurations */
+	check_ddrphy_cfg,
+	check_fsp_msg,
+	check_ddrphy_trained_csr,
+	check_ddrphy_pie,
+};
+
+struct load_job {
+	const char *path;
+	struct ddrconf *conf;
+	struct timing_tables *tables;
+	int ret;
+};
+
+/* Rendered output of one section */
+struct section_report {
+	char *buf;
+	size_t len;
+};
+
+/* Bounded FIFO between the compare and output stages */
+struct report_queue {
+	struct section_report slots[REPORT_QUEUE_DEPTH];
+	unsigned int head;
+	unsigned int count;
+	int done;
+	int ret;
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+};
+
+static void *load_worker(void *arg) {
+	struct load_job *job = arg;
+
+	job->ret = ddrconf_load(job->path, job->conf);
+	if (job->ret == 0 && timing_tables_build(job->tables, &job->conf->timing) != 0) {
+		fprintf(stderr, "%s: out of memory\n", job->path);
+		job->ret = -1;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Load both configurations, in parallel when a thread is available
+ *
+ * @return 0 on success, -1 if either side failed (a message has been printed)
+ */
+static int load_configs(const char *left_path, const char *right_path) {
+	struct load_job jobs[2] = {
+		{ left_path, &conf_left, &tables_left, -1 },
+		{ right_path, &conf_right, &tables_right, -1 },
+	};
+	pthread_t thread;
+	int threaded;
+
+	threaded = (pthread_create(&thread, NULL, load_worker, &jobs[1]) == 0);
+	load_worker(&jobs[0]);
+	if (threaded) {
+		pthread_join(thread, NULL);
+	} else {
+		load_worker(&jobs[1]);
+	}
+
+	if (jobs[0].ret != 0 || jobs[1].ret != 0) {
+		timing_tables_free(&tables_left);
+		timing_tables_free(&tables_right);
+		ddrconf_free(&conf_left);
+		ddrconf_free(&conf_right);
+		return -1;
+	}
+
+	dram_timing_left = conf_left.timing;
+	dram_timing_right = conf_right.timing;
+
+	return 0;
+}
+
+/**
+ * @brief Compare stage: render every section into a buffer and queue it
+ */
+static void *compare_worker(void *arg) {
+	struct report_queue *queue = arg;
+
+	for (unsigned int i = 0; i < ARRAY_SIZE(check_sections); i++) {
+		struct section_report report = { NULL, 0 };
+		int ret = 0;
+
+		out = open_memstream(&report.buf, &report.len);
+		if (out) {
+			ret = check_sections[i]();
+			scratch_reset();
+			fclose(out);
+		} else {
+			fprintf(stderr, "Out of memory rendering section %u\n", i);
+		}
+
+		pthread_mutex_lock(&queue->lock);
+		while (queue->count == REPORT_QUEUE_DEPTH) {
+			pthread_cond_wait(&queue->not_full, &queue->lock);
+		}
+		queue->slots[(queue->head + queue->count) % REPORT_QUEUE_DEPTH] = report;
+		queue->count++;
+		queue->ret |= ret;
+		pthread_cond_signal(&queue->not_empty);
+		pthread_mutex_unlock(&queue->lock);
+	}
+
+	pthread_mutex_lock(&queue->lock);
+	queue->done = 1;
+	pthread_cond_signal(&queue->not_empty);
+	pthread_mutex_unlock(&queue->lock);
+
+	return NULL;
+}
+
+/**
+ * @brief Compare all sections, writing each to stdout as soon as it is done
+ *
+ * @return OR of the section check results
+ */
+static int run_checks(void) {
+	struct report_queue queue;
+	pthread_t thread;
 	int ret = 0;
+
+	memset(&queue, 0, sizeof(queue));
+	pthread_mutex_init(&queue.lock, NULL);
+	pthread_cond_init(&queue.not_empty, NULL);
+	pthread_cond_init(&queue.not_full, NULL);
+
+	if (pthread_create(&thread, NULL, compare_worker, &queue) != 0) {
+		/* No compare thread: render straight to stdout */
+		for (unsigned int i = 0; i < ARRAY_SIZE(check_sections); i++) {
+			ret |= check_sections[i]();
+			scratch_reset();
+			fflush(stdout);
+		}
+		goto out_destroy;
+	}
+
+	/* Output stage */
+	pthread_mutex_lock(&queue.lock);
+	for (;;) {
+		struct section_report report;
+
+		while (queue.count == 0 && !queue.done) {
+			pthread_cond_wait(&queue.not_empty, &queue.lock);
+		}
+		if (queue.count == 0) {
+			break;
+		}
+		report = queue.slots[queue.head];
+		queue.head = (queue.head + 1) % REPORT_QUEUE_DEPTH;
+		queue.count--;
+		pthread_cond_signal(&queue.not_full);
+		pthread_mutex_unlock(&queue.lock);
+
+		if (report.buf) {
+			fwrite(report.buf, 1, report.len, stdout);
+			fflush(stdout);
+			free(report.buf);
+		}
+
+		pthread_mutex_lock(&queue.lock);
+	}
+	pthread_mutex_unlock(&queue.lock);
+
+	pthread_join(thread, NULL);
+	out = stdout;
+	ret = queue.ret;
+
+out_destroy:
+	pthread_cond_destroy(&queue.not_full);
+	pthread_cond_destroy(&queue.not_empty);
+	pthread_mutex_destroy(&queue.lock);
+
+	return ret;
+}
+
+int main(int argc, char *argv[]) {
+	const char *paths[2];
+	int num_paths = 0;
+	const char *cache_dir = getenv("DDRCONF_CACHE_DIR");
+	const char *compiler = NULL;
+	const char *readback = NULL;
+	int ret;
 	
 	/* Parse command-line arguments */
 	for (int i = 1; i < argc; i++) {
 		if (strcmp(argv[i], "--list-duplicates") == 0) {
 			opt_list_duplicates = 1;
+		} else if (strcmp(argv[i], "--ignore-order") == 0) {
+			opt_ignore_order = 1;
+		} else if (strcmp(argv[i], "--effective") == 0) {
+			opt_effective = 1;
+		} else if (strcmp(argv[i], "--stats") == 0) {
+			opt_stats = 1;
+		} else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+			cache_dir = argv[++i];
+		} else if (strcmp(argv[i], "--compile") == 0) {
+			compiler = getenv("CC");
+			if (!compiler || !compiler[0]) {
+				compiler = "cc";
+			}
+		} else if (strcmp(argv[i], "--readback") == 0 && i + 1 < argc) {
+			readback = argv[++i];
+		} else if (strcmp(argv[i], "--phy-base") == 0 && i + 1 < argc) {
+			char *end;
+			opt_phy_base = strtoul(argv[++i], &end, 0);
+			if (*end || !argv[i][0]) {
+				fprintf(stderr, "Invalid PHY base address: %s\n", argv[i]);
+				return 1;
+			}
+			opt_have_phy_base = 1;
 		} else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
-			printf("Usage: %s [OPTIONS]\n", argv[0]);
+			printf("Usage: %s [OPTIONS] LEFT RIGHT\n", argv[0]);
+			printf("       %s [OPTIONS] --readback LOG CONFIG\n", argv[0]);
+			printf("Compare two configurations (lpddr5_timing.c, .ddrsnap, ddrconfdump output\n");
+			printf("or a firmware image).\n");
 			printf("Options:\n");
 			printf("  --list-duplicates  Show detailed list of duplicate registers\n");
+			printf("  --ignore-order     Compare register sets and values regardless of order\n");
+			printf("  --effective        Compare the final register state (last write wins)\n");
+			printf("  --cache-dir DIR    Cache parsed sources in DIR (default: $DDRCONF_CACHE_DIR)\n");
+			printf("  --compile          Load sources by compiling them with $CC into cached .so files\n");
+			printf("  --readback LOG     Diff a memtool/devmem readback log (\"-\" for stdin) against CONFIG\n");
+			printf("  --phy-base ADDR    Readback address of PHY register 0 (PHY register N at ADDR + 4*N)\n");
+			printf("  --stats            Print scratch memory statistics to stderr\n");
 			printf("  --help, -h         Show this help message\n");
 			return 0;
-		} else {
+		} else if (argv[i][0] == '-') {
 			fprintf(stderr, "Unknown option: %s\n", argv[i]);
 			fprintf(stderr, "Use --help for usage information\n");
 			return 1;
+		} else if (num_paths < 2) {
+			paths[num_paths++] = argv[i];
+		} else {
+			fprintf(stderr, "Too many arguments: %s\n", argv[i]);
+			fprintf(stderr, "Use --help for usage information\n");
+			return 1;
 		}
 	}
 	
-	printf("\n");
-	printf("═══════════════════════════════════════════════════════════════════════════\n");
-	printf("                    DDR Configuration Comparison Tool                      \n");
-	printf("═══════════════════════════════════════════════════════════════════════════\n");
-	printf("\n");
+	if (readback && num_paths != 1) {
+		fprintf(stderr, "One configuration file is required with --readback\n");
+		fprintf(stderr, "Use --help for usage information\n");
+		return 1;
+	}
+	if (!readback && num_paths != 2) {
+		fprintf(stderr, "Two configuration files are required\n");
+		fprintf(stderr, "Use --help for usage information\n");
+		return 1;
+	}
 	
-	/** DDRC configurations */
-	ret = check_ddrc_cfg();
-	ret |= check_fsp_cfg();
-
-	/** DDR PHY configurations */
-	ret |= check_ddrphy_cfg();
-	ret |= check_fsp_msg();
-	ret |= check_ddrphy_trained_csr();
-	ret |= check_ddrphy_pie();
+	ddrconf_set_cache_dir(cache_dir);
+	ddrconf_set_compiler(compiler);
+	out = stdout;
+	
+	if (readback) {
+		if (ddrconf_load(paths[0], &conf_left) != 0) {
+			return 1;
+		}
+		dram_timing_left = conf_left.timing;
+		
+		fprintf(out, "\n");
+		fprintf(out, "═══════════════════════════════════════════════════════════════════════════\n");
+		fprintf(out, "                      DDR Register Readback Check                          \n");
+		fprintf(out, "═══════════════════════════════════════════════════════════════════════════\n");
+		fprintf(out, "\n");
+		
+		ret = check_readback(readback);
+		ddrconf_free(&conf_left);
+		
+		/* Mismatches fail the run, so boot loop scripts can stop on them */
+		return ret < 0 ? 1 : (ret ? 255 : 0);
+	}
+	
+	if (load_configs(paths[0], paths[1]) != 0) {
+		return 1;
+	}
+	
+	fprintf(out, "\n");
+	fprintf(out, "═══════════════════════════════════════════════════════════════════════════\n");
+	fprintf(out, "                    DDR Configuration Comparison Tool                      \n");
+	fprintf(out, "═══════════════════════════════════════════════════════════════════════════\n");
+	fprintf(out, "\n");
+	fflush(stdout);
+	
+	/* Differences are informational and do not affect the exit status */
+	run_checks();
 	
 	/* Calculate and print total sizes */
-	printf("┌─────────────────────────────────────────────────────────────────────────┐\n");
-	printf("│ Total Configuration Sizes                                               │\n");
-	printf("└─────────────────────────────────────────────────────────────────────────┘\n");
+	fprintf(out, "┌─────────────────────────────────────────────────────────────────────────┐\n");
+	fprintf(out, "│ Total Configuration Sizes                                               │\n");
+	fprintf(out, "└─────────────────────────────────────────────────────────────────────────┘\n");
 	
 	unsigned int left_total = 0;
 	unsigned int right_total = 0;
@@ -2023,18 +2688,30 @@ int main(int argc, char *argv[]) {
 	left_total += dram_timing_left.ddrphy_pie_num * sizeof(struct ddrphy_cfg_param);
 	right_total += dram_timing_right.ddrphy_pie_num * sizeof(struct ddrphy_cfg_param);
 	
-	printf("  Left:  %u bytes (%.2f kB)\n", left_total, left_total / 1024.0);
-	printf("  Right: %u bytes (%.2f kB)\n", right_total, right_total / 1024.0);
+	fprintf(out, "  Left:  %u bytes (%.2f kB)\n", left_total, left_total / 1024.0);
+	fprintf(out, "  Right: %u bytes (%.2f kB)\n", right_total, right_total / 1024.0);
 	if (left_total != right_total) {
 		int diff = (int)right_total - (int)left_total;
-		printf("  Difference: %+d bytes (%+.2f kB)\n", diff, diff / 1024.0);
+		fprintf(out, "  Difference: %+d bytes (%+.2f kB)\n", diff, diff / 1024.0);
 	}
-	printf("\n");
+	fprintf(out, "\n");
 	
-	printf("═══════════════════════════════════════════════════════════════════════════\n");
+	fprintf(out, "═══════════════════════════════════════════════════════════════════════════\n");
 	print_info("                      ", "COMPARISON COMPLETE");
-	printf("═══════════════════════════════════════════════════════════════════════════\n");
-	printf("\n");
+	fprintf(out, "═══════════════════════════════════════════════════════════════════════════\n");
+	fprintf(out, "\n");
+	
+	if (opt_stats) {
+		fprintf(stderr, "Scratch arena: %lu allocations in %u sections, %lu from the system, "
+		        "largest section %zu bytes\n",
+		        scratch.allocs, scratch.resets, scratch.system_allocs, scratch.peak);
+	}
+	
+	timing_tables_free(&tables_left);
+	timing_tables_free(&tables_right);
+	scratch_free();
+	ddrconf_free(&conf_left);
+	ddrconf_free(&conf_right);
 	
 	return 0;  /* Always return success - comparison completed successfully */
 }
@@ -11,15 +11,21 @@
  *   crc32=0x<checksum>
  *   <reg offset> <reg value>
  *   ...
+ * 
+ * The configuration is loaded at runtime (lpddr5_timing.c source or
+ * .ddrsnap snapshot, see ddrconf.h). With --snapshot the tool also writes
+ * a binary snapshot that ddrconfcmp can load without parsing.
  */
 
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
+#include <stdlib.h>
 #include "ddr.h"
+#include "ddrconf.h"
 
-/* The timing configuration will be included at compile time */
-#include "lpddr5_timing.c"
+/* Configuration being dumped, loaded from the command line */
+static struct dram_timing_info dram_timing;
 
 /**
  * @brief Calculate CRC32 checksum
@@ -189,7 +195,60 @@ static void dump_ddrphy_pie(void) {
 	                      dram_timing.ddrphy_pie_num);
 }
 
-int main(void) {
+int main(int argc, char *argv[]) {
+	const char *snapshot_path = NULL;
+	const char *path = NULL;
+	const char *cache_dir = getenv("DDRCONF_CACHE_DIR");
+	const char *compiler = NULL;
+	struct ddrconf conf;
+	
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+			snapshot_path = argv[++i];
+		} else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+			cache_dir = argv[++i];
+		} else if (strcmp(argv[i], "--compile") == 0) {
+			compiler = getenv("CC");
+			if (!compiler || !compiler[0]) {
+				compiler = "cc";
+			}
+		} else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+			printf("Usage: %s [OPTIONS] CONFIG\n", argv[0]);
+			printf("Dump an lpddr5_timing.c or .ddrsnap configuration.\n");
+			printf("Options:\n");
+			printf("  --snapshot FILE  Also write a binary .ddrsnap snapshot to FILE\n");
+			printf("  --cache-dir DIR  Cache parsed sources in DIR (default: $DDRCONF_CACHE_DIR)\n");
+			printf("  --compile        Load sources by compiling them with $CC into cached .so files\n");
+			printf("  --help, -h       Show this help message\n");
+			return 0;
+		} else if (argv[i][0] == '-' || path) {
+			fprintf(stderr, "Unexpected argument: %s\n", argv[i]);
+			fprintf(stderr, "Use --help for usage information\n");
+			return 1;
+		} else {
+			path = argv[i];
+		}
+	}
+	
+	if (!path) {
+		fprintf(stderr, "A configuration file is required\n");
+		fprintf(stderr, "Use --help for usage information\n");
+		return 1;
+	}
+	
+	ddrconf_set_cache_dir(cache_dir);
+	ddrconf_set_compiler(compiler);
+	
+	if (ddrconf_load(path, &conf) != 0) {
+		return 1;
+	}
+	dram_timing = conf.timing;
+	
+	if (snapshot_path && ddrconf_write_snapshot(&dram_timing, snapshot_path) != 0) {
+		ddrconf_free(&conf);
+		return 1;
+	}
+	
 	printf("═══════════════════════════════════════════════════════════════════════════\n");
 	printf("                     DDR Configuration Dump Tool                           \n");
 	printf("═══════════════════════════════════════════════════════════════════════════\n");
@@ -208,5 +267,7 @@ int main(void) {
 	printf("═══════════════════════════════════════════════════════════════════════════\n");
 	printf("\n");
 	
+	ddrconf_free(&conf);
+	
 	return 0;
 }
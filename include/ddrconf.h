@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright 2025 Variscite Ltd.
+ *
+ * Runtime loading of DDR timing configurations into the
+ * struct dram_timing_info layout from ddr.h.
+ */
+
+#ifndef __DDRCONF_H
+#define __DDRCONF_H
+#include <stddef.h>
+#include "ddr.h"
+
+/*
+ * A loaded configuration. All arrays referenced from timing live either
+ * in one heap block or in a read-only file mapping (snapshots), both
+ * owned by the configuration and released by ddrconf_free().
+ */
+struct ddrconf
+{
+    struct dram_timing_info timing;
+    void *mem;
+    size_t mem_size;
+    void *map;
+    size_t map_size;
+};
+
+/* Load a configuration, picking the reader from the file contents */
+int ddrconf_load(const char *path, struct ddrconf *conf);
+
+/* Parse a DDR Tool generated lpddr5_timing.c source */
+int ddrconf_load_source(const char *path, struct ddrconf *conf);
+
+/* Parse lpddr5_timing.c text already held in memory */
+int ddrconf_parse_source(const char *path, const char *buf, struct ddrconf *conf);
+
+/*
+ * Revision of the results of ddrconf_parse_source(). It is part of the
+ * parse cache key, so bump it with every parser change that alters what
+ * a source parses to; results cached by older parsers are then ignored.
+ */
+#define DDRCONF_PARSER_REVISION 2
+
+/*
+ * Parse cache: sources are keyed by a hash of their contents and the
+ * parser revision, and stored as .ddrsnap snapshots in dir (NULL
+ * disables the cache).
+ */
+void ddrconf_set_cache_dir(const char *dir);
+int ddrconf_cache_lookup(const char *buf, size_t size, struct ddrconf *conf);
+void ddrconf_cache_store(const char *buf, size_t size, const struct dram_timing_info *timing);
+const char *ddrconf_get_cache_dir(void);
+unsigned long long ddrconf_hash(const char *buf, size_t size);
+int ddrconf_make_dirs(const char *dir);
+
+/*
+ * Compile sources with cc into shared objects exporting dram_timing and
+ * dlopen() them instead of parsing (NULL disables). Objects are keyed by
+ * content hash and kept in the cache directory, or next to the source.
+ */
+void ddrconf_set_compiler(const char *cc);
+int ddrconf_use_compiler(void);
+int ddrconf_load_shared(const char *path, struct ddrconf *conf);
+
+/* Title line identifying ddrconfdump text output */
+#define DDRCONF_DUMP_TITLE "DDR Configuration Dump Tool"
+
+/* Read ddrconfdump text output, verifying the recorded CRCs */
+int ddrconf_load_dump(const char *path, struct ddrconf *conf);
+
+/* Extract the tables embedded in a built firmware image */
+int ddrconf_load_image(const char *path, struct ddrconf *conf);
+
+/*
+ * Stream a memtool/devmem style readback log ("ADDR: VAL [VAL...]" lines)
+ * through fn, one call per register read, in constant memory.
+ */
+typedef int (*ddrconf_readback_fn)(void *ctx, unsigned int addr, unsigned int val,
+                                   unsigned long line);
+int ddrconf_read_readback(const char *path, ddrconf_readback_fn fn, void *ctx);
+
+/* Map a .ddrsnap binary snapshot and use its arrays in place */
+int ddrconf_load_snapshot(const char *path, struct ddrconf *conf);
+
+/* Write a .ddrsnap binary snapshot of a timing description */
+int ddrconf_write_snapshot(const struct dram_timing_info *timing, const char *path);
+
+/* Deep-copy a timing description into a single block owned by conf */
+int ddrconf_pack(const struct dram_timing_info *src, struct ddrconf *conf);
+
+/* Release all memory held by conf */
+void ddrconf_free(struct ddrconf *conf);
+
+/* Read a whole file into a NUL-terminated heap buffer */
+char *ddrconf_read_file(const char *path, size_t *size);
+
+#endif /* __DDRCONF_H */
@@ -0,0 +1,81 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright 2025 Variscite Ltd.
+ *
+ * On-disk layout of .ddrsnap binary configuration snapshots.
+ *
+ * A snapshot is a single file that can be mmap()ed and used in place:
+ *
+ *   struct ddrsnap_header
+ *   struct ddrsnap_fsp_cfg   [fsp_cfg_num]
+ *   struct ddrsnap_fsp_msg   [fsp_msg_num]
+ *   struct ddrsnap_array     [num_arrays]
+ *   array data, each array starting on a DDRSNAP_ALIGN boundary
+ *
+ * Register arrays are stored with the exact in-memory layout of
+ * struct ddrc_cfg_param / struct ddrphy_cfg_param, so readers point the
+ * dram_timing_info fields straight into the mapping. All integers are in
+ * host byte order; byte_order lets readers reject foreign snapshots.
+ */
+
+#ifndef __DDRSNAP_H
+#define __DDRSNAP_H
+#include <stdint.h>
+
+#define DDRSNAP_MAGIC       "DDRSNAP"   /* 7 characters plus NUL */
+#define DDRSNAP_VERSION     1U
+#define DDRSNAP_BYTE_ORDER  0x01020304U
+#define DDRSNAP_ALIGN       8U
+
+/* Identifiers of the arrays referenced by struct dram_timing_info */
+enum ddrsnap_array_id
+{
+    DDRSNAP_DDRC_CFG = 1,
+    DDRSNAP_FSP_DDRC_CFG,            /* fsp_cfg[index].ddrc_cfg */
+    DDRSNAP_FSP_MR_CFG,              /* fsp_cfg[index].mr_cfg */
+    DDRSNAP_DDRPHY_CFG,
+    DDRSNAP_FSP_PHY_CFG,             /* fsp_msg[index].fsp_phy_cfg */
+    DDRSNAP_FSP_PHY_MSGH_CFG,        /* fsp_msg[index].fsp_phy_msgh_cfg */
+    DDRSNAP_FSP_PHY_PIE_CFG,         /* fsp_msg[index].fsp_phy_pie_cfg */
+    DDRSNAP_FSP_PHY_PROG_CSR_PS_CFG, /* fsp_msg[index].fsp_phy_prog_csr_ps_cfg */
+    DDRSNAP_DDRPHY_TRAINED_CSR,
+    DDRSNAP_DDRPHY_PIE,
+    DDRSNAP_DDRPHY_PROG_CSR,
+};
+
+struct ddrsnap_header
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t file_size;
+    uint32_t num_arrays;
+    uint32_t fsp_cfg_num;
+    uint32_t fsp_msg_num;
+    /* dram_timing_info scalars */
+    uint32_t fsp_table[4];
+    uint32_t skip_fw;
+    uint32_t prog_csr;
+};
+
+struct ddrsnap_fsp_cfg
+{
+    uint32_t bypass;
+};
+
+struct ddrsnap_fsp_msg
+{
+    uint32_t drate;
+    uint32_t ssc;
+    uint32_t fw_type;
+};
+
+struct ddrsnap_array
+{
+    uint32_t id;      /* enum ddrsnap_array_id */
+    uint32_t index;   /* FSP index for per-FSP arrays, 0 otherwise */
+    uint32_t offset;  /* from the start of the file */
+    uint32_t num;     /* number of entries */
+};
+
+#endif /* __DDRSNAP_H */